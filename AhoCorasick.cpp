@@ -0,0 +1,116 @@
+#include "AhoCorasick.h"
+#include <algorithm>
+#include <cctype>
+#include <queue>
+
+AhoCorasick::AhoCorasick() {
+    build({});
+}
+
+AhoCorasick::AhoCorasick(const std::vector<std::string>& words) {
+    build(words);
+}
+
+int AhoCorasick::addState(int depth) {
+    State state;
+    state.next.fill(-1);
+    state.fail = 0;
+    state.dictLink = -1;
+    state.match = -1;
+    state.depth = depth;
+    states.push_back(state);
+    return static_cast<int>(states.size()) - 1;
+}
+
+int AhoCorasick::insert(const std::string& pattern) {
+    int state = root();
+    for (char c : pattern) {
+        int index = c - 'A';
+        if (states[state].next[index] < 0) {
+            int created = addState(states[state].depth + 1);  // May reallocate
+            states[state].next[index] = created;
+        }
+        state = states[state].next[index];
+    }
+    return state;
+}
+
+void AhoCorasick::addMatch(int state, int word, bool reversed) {
+    matches.push_back({ word, reversed, states[state].match });
+    states[state].match = static_cast<int>(matches.size()) - 1;
+}
+
+void AhoCorasick::build(const std::vector<std::string>& words) {
+    states.clear();
+    matches.clear();
+    canonical.assign(words.size(), -1);
+    uniqueWords = 0;
+    maxLength = 0;
+    addState(0);
+
+    for (size_t i = 0; i < words.size(); ++i) {
+        std::string pattern = words[i];
+        bool valid = !pattern.empty();
+        for (char& c : pattern) {
+            if (!std::isalpha(static_cast<unsigned char>(c))) {
+                valid = false;
+                break;
+            }
+            c = std::toupper(static_cast<unsigned char>(c));
+        }
+        if (!valid) {
+            continue;
+        }
+
+        int state = insert(pattern);
+        int existing = -1;
+        for (int m = states[state].match; m >= 0; m = matches[m].next) {
+            if (!matches[m].reversed) {
+                existing = matches[m].word;
+                break;
+            }
+        }
+        if (existing >= 0) {
+            canonical[i] = existing;  // Duplicate spelling, already covered
+            continue;
+        }
+
+        canonical[i] = static_cast<int>(i);
+        uniqueWords++;
+        maxLength = std::max(maxLength, static_cast<int>(pattern.length()));
+        addMatch(state, static_cast<int>(i), false);
+        // Reversed copy covers W, N, NW and NE; palindromes get both entries
+        // so they are reported from each end like the trie scan does
+        addMatch(insert(std::string(pattern.rbegin(), pattern.rend())), static_cast<int>(i), true);
+    }
+
+    // Breadth-first pass turns the trie into a full transition table
+    std::queue<int> pending;
+    for (int c = 0; c < kAlphabetSize; ++c) {
+        int child = states[root()].next[c];
+        if (child < 0) {
+            states[root()].next[c] = root();
+        }
+        else {
+            states[child].fail = root();
+            pending.push(child);
+        }
+    }
+    while (!pending.empty()) {
+        int state = pending.front();
+        pending.pop();
+        int fail = states[state].fail;
+        states[state].dictLink = states[fail].match >= 0 ? fail : states[fail].dictLink;
+
+        for (int c = 0; c < kAlphabetSize; ++c) {
+            int child = states[state].next[c];
+            if (child < 0) {
+                states[state].next[c] = states[fail].next[c];
+            }
+            else {
+                states[child].fail = states[fail].next[c];
+                pending.push(child);
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Aho-Corasick automaton over a word list and the reverse of every word, so a
+// single left-to-right pass over a grid line also finds words that read
+// right-to-left. Transitions are a full table, one lookup per letter.
+class AhoCorasick {
+public:
+    static constexpr int kAlphabetSize = 26;
+
+    // One word ending at a state, read either forwards or reversed
+    struct Match {
+        int word;
+        bool reversed;
+        int next;  // Next match stored at the same state, or -1
+    };
+
+    AhoCorasick();
+    explicit AhoCorasick(const std::vector<std::string>& words);
+
+    // Rebuilds the automaton (letters are upper-cased, words containing
+    // anything other than A-Z are ignored)
+    void build(const std::vector<std::string>& words);
+
+    int root() const { return 0; }
+
+    // State after reading a grid letter; anything outside A-Z restarts at the root
+    int next(int state, char letter) const {
+        unsigned index = static_cast<unsigned char>(letter) - 'A';
+        return index < kAlphabetSize ? states[state].next[index] : 0;
+    }
+
+    // The state itself if words end there, otherwise the nearest suffix state
+    // with words ending at it; -1 when nothing matches
+    int firstOutput(int state) const {
+        return states[state].match >= 0 ? state : states[state].dictLink;
+    }
+    int nextOutput(int state) const { return states[state].dictLink; }
+
+    // Matches stored at an output state, and the length of the text they cover
+    int firstMatch(int state) const { return states[state].match; }
+    const Match& match(int index) const { return matches[index]; }
+    int depth(int state) const { return states[state].depth; }
+
+    int wordCount() const { return static_cast<int>(canonical.size()); }
+    int uniqueWordCount() const { return uniqueWords; }
+    int canonicalIndex(int i) const { return canonical[i]; }
+    int maxPatternLength() const { return maxLength; }
+
+private:
+    struct State {
+        std::array<int, kAlphabetSize> next;
+        int fail;
+        int dictLink;
+        int match;
+        int depth;
+    };
+
+    int addState(int depth);
+    int insert(const std::string& pattern);
+    void addMatch(int state, int word, bool reversed);
+
+    std::vector<State> states;
+    std::vector<Match> matches;
+    std::vector<int> canonical;
+    int uniqueWords = 0;
+    int maxLength = 0;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "AllocationCounter.h"
+
+#ifdef COUNT_HEAP_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Per thread, so no core contends on it and readings are not mixed up with
+// other threads' work
+thread_local size_t allocations = 0;
+
+void* allocate(size_t size) {
+    allocations++;
+    if (void* block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+}
+
+size_t heapAllocationCount() {
+    return allocations;
+}
+
+// The nothrow forms forward to these, so they are counted as well
+void* operator new(size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](size_t size) {
+    return allocate(size);
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    std::free(block);
+}
+
+#else
+
+size_t heapAllocationCount() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+// Debug builds count heap allocations; define COUNT_HEAP_ALLOCATIONS to count
+// them in other builds too. Only then does AllocationCounter.cpp replace the
+// global operator new and the game show the count in its top bar.
+#if defined(_DEBUG) && !defined(COUNT_HEAP_ALLOCATIONS)
+#define COUNT_HEAP_ALLOCATIONS
+#endif
+
+// Heap allocations made through global operator new by the calling thread
+// since it started (always 0 when not counting). Comparing two readings on
+// one thread shows whether its code in between allocated, e.g. one UI
+// frame, whatever background threads do meanwhile.
+size_t heapAllocationCount();
+
+#endif
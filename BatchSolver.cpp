@@ -0,0 +1,116 @@
+#include "BatchSolver.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include "Grid.h"
+#include "GridSearch.h"
+#include "ThreadPool.h"
+#include "WordTrie.h"
+
+namespace {
+
+// Buffers kept per thread and reused for every puzzle it solves
+struct BatchScratch {
+    Grid grid;
+    WordTrie trie;
+    std::vector<WordHit> hits;
+    std::vector<uint32_t> counts;
+    std::vector<uint8_t> lengths;  // Per trie word: 0 unless a palindrome, else its length
+};
+
+// A palindrome is also found read backwards from its last letter, and a
+// one-letter word in all eight directions from its cell. Those hits cover
+// the same cells as another hit, so only one of them is counted: the one in
+// the first direction of each opposite pair (E, S, SE, SW), or E alone for
+// a single letter.
+bool countsAsOccurrence(const WordHit& hit, uint8_t palindromeLength) {
+    if (palindromeLength == 0) {
+        return true;
+    }
+    if (palindromeLength == 1) {
+        return hit.dir == 0;
+    }
+    return hit.dir == 0 || hit.dir == 1 || hit.dir == 4 || hit.dir == 5;
+}
+
+bool isPalindrome(const std::string& word) {
+    for (size_t i = 0, j = word.size(); i + 1 < j; ++i, --j) {
+        if (std::toupper(static_cast<unsigned char>(word[i])) != std::toupper(static_cast<unsigned char>(word[j - 1]))) {
+            return false;
+        }
+    }
+    return !word.empty();
+}
+
+void solveOne(const PuzzleView& puzzle, PuzzleResult& result, BatchScratch& scratch) {
+    scratch.grid.reset(puzzle.width, puzzle.height);
+    for (int r = 0; r < puzzle.height; ++r) {
+        std::memcpy(scratch.grid[r], puzzle.cells + static_cast<size_t>(r) * puzzle.stride, puzzle.width);
+    }
+    scratch.trie.build(puzzle.words, puzzle.wordCount);
+
+    size_t hitCount = findHitsWithTrie(scratch.grid, scratch.trie, scratch.hits.data(), scratch.hits.size());
+    if (hitCount > scratch.hits.size()) {
+        scratch.hits.resize(hitCount * 2);
+        hitCount = findHitsWithTrie(scratch.grid, scratch.trie, scratch.hits.data(), scratch.hits.size());
+    }
+
+    scratch.lengths.assign(puzzle.wordCount, 0);
+    for (size_t i = 0; i < puzzle.wordCount; ++i) {
+        int index = scratch.trie.canonicalIndex(static_cast<int>(i));
+        if (index >= 0 && isPalindrome(puzzle.words[i])) {
+            scratch.lengths[index] = static_cast<uint8_t>(std::min<size_t>(puzzle.words[i].size(), 255));
+        }
+    }
+
+    // Occurrences are distinct sets of cells, not raw hits
+    scratch.counts.assign(puzzle.wordCount, 0);
+    uint32_t occurrenceCount = 0;
+    for (size_t k = 0; k < hitCount; ++k) {
+        const WordHit& hit = scratch.hits[k];
+        if (countsAsOccurrence(hit, scratch.lengths[hit.wordIndex])) {
+            scratch.counts[hit.wordIndex]++;
+            occurrenceCount++;
+        }
+    }
+
+    result = {};
+    result.hitCount = occurrenceCount;
+    for (size_t i = 0; i < puzzle.wordCount; ++i) {
+        int index = scratch.trie.canonicalIndex(static_cast<int>(i));
+        uint32_t occurrences = index >= 0 ? scratch.counts[index] : 0;
+        if (occurrences > 0) {
+            result.wordsFound++;
+        }
+        if (occurrences > 1) {
+            result.wordsRepeated++;
+        }
+    }
+    result.allFound = result.wordsFound == puzzle.wordCount;
+}
+
+}
+
+BatchStats solveBatch(const PuzzleView* puzzles, size_t count, PuzzleResult* results) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Chunks small enough to balance across threads, large enough that the
+    // pool overhead is negligible next to a few microseconds per puzzle
+    const size_t chunkSize = 256;
+    size_t chunks = (count + chunkSize - 1) / chunkSize;
+    ThreadPool::shared().parallelFor(chunks, [&](size_t chunk) {
+        thread_local BatchScratch scratch;
+        size_t end = std::min(count, (chunk + 1) * chunkSize);
+        for (size_t i = chunk * chunkSize; i < end; ++i) {
+            solveOne(puzzles[i], results[i], scratch);
+        }
+    });
+
+    BatchStats stats;
+    stats.puzzles = count;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.puzzlesPerSecond = stats.seconds > 0 ? count / stats.seconds : 0;
+    return stats;
+}
@@ -0,0 +1,40 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Non-owning view of one puzzle to verify: row-major letters with a row
+// stride, plus the words it is supposed to contain
+struct PuzzleView {
+    const char* cells;
+    int width;
+    int height;
+    int stride;
+    const std::string* words;
+    size_t wordCount;
+};
+
+// Verification result for one puzzle
+struct PuzzleResult {
+    uint32_t wordsFound;      // Words occurring at least once
+    uint32_t wordsRepeated;   // Words occurring more than once (ambiguous)
+    uint32_t hitCount;        // Total occurrences of all words (a palindrome read
+                              // both ways counts once)
+    bool allFound;
+};
+
+struct BatchStats {
+    size_t puzzles;
+    double seconds;
+    double puzzlesPerSecond;
+};
+
+// Solves many small puzzles concurrently. Puzzles are sharded across the
+// shared thread pool in chunks, each puzzle is scanned on one thread, and
+// every thread reuses its own trie, grid and hit buffers from one puzzle to
+// the next. results must have room for count entries.
+BatchStats solveBatch(const PuzzleView* puzzles, size_t count, PuzzleResult* results);
+
+#endif
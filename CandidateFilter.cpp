@@ -0,0 +1,139 @@
+#include "CandidateFilter.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CANDIDATE_FILTER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CANDIDATE_FILTER_AVX2
+#else
+#define CANDIDATE_FILTER_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+bool detectAvx2() {
+#if !defined(CANDIDATE_FILTER_X86)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+    if (!osSavesAvx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#ifdef CANDIDATE_FILTER_X86
+CANDIDATE_FILTER_AVX2
+void blockMasksAvx2(const Grid& grid, int r, int c, const char* firstLetters, int firstCount,
+    const std::pair<char, uint32_t>* secondLetters, int secondCount, uint32_t masks[kDirectionCount]) {
+    __m256i cells = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(grid[r] + c));
+    __m256i firstEq[WordTrie::kAlphabetSize];
+    __m256i anyFirst = _mm256_setzero_si256();
+    for (int i = 0; i < firstCount; ++i) {
+        firstEq[i] = _mm256_cmpeq_epi8(cells, _mm256_set1_epi8(firstLetters[i]));
+        anyFirst = _mm256_or_si256(anyFirst, firstEq[i]);
+    }
+    if (_mm256_movemask_epi8(anyFirst) == 0) {
+        for (int d = 0; d < kDirectionCount; ++d) {
+            masks[d] = 0;
+        }
+        return;
+    }
+
+    // Cells whose letter can be followed by each second letter; the same for
+    // every direction, so only the neighbour compare is done per direction
+    __m256i follows[WordTrie::kAlphabetSize];
+    for (int j = 0; j < secondCount; ++j) {
+        follows[j] = _mm256_setzero_si256();
+        for (int i = 0; i < firstCount; ++i) {
+            if ((secondLetters[j].second >> i) & 1) {
+                follows[j] = _mm256_or_si256(follows[j], firstEq[i]);
+            }
+        }
+    }
+
+    for (int d = 0; d < kDirectionCount; ++d) {
+        const auto& [dr, dc] = kDirections[d];
+        int nr = r + dr;
+        if (nr < 0 || nr >= grid.height()) {
+            masks[d] = 0;
+            continue;
+        }
+        __m256i neighbours = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(grid[nr] + c + dc));
+        __m256i hits = _mm256_setzero_si256();
+        for (int j = 0; j < secondCount; ++j) {
+            __m256i secondEq = _mm256_cmpeq_epi8(neighbours, _mm256_set1_epi8(secondLetters[j].first));
+            hits = _mm256_or_si256(hits, _mm256_and_si256(follows[j], secondEq));
+        }
+        masks[d] = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+    }
+}
+#endif
+
+}
+
+bool CandidateFilter::cpuSupported() {
+    static const bool supported = detectAvx2();
+    return supported;
+}
+
+bool CandidateFilter::build(const WordTrie& trie) {
+    firstCount = 0;
+    secondCount = 0;
+    if (!cpuSupported()) {
+        return false;
+    }
+
+    uint32_t followers[WordTrie::kAlphabetSize] = {};
+    int pairs = 0;
+    for (int a = 0; a < WordTrie::kAlphabetSize; ++a) {
+        int first = trie.child(trie.root(), static_cast<char>('A' + a));
+        if (first == WordTrie::kNoNode) {
+            continue;
+        }
+        if (trie.wordAt(first) >= 0) {
+            return false;  // A one-letter word has no second letter to filter on
+        }
+        uint32_t firstIndex = static_cast<uint32_t>(firstCount);
+        firstLetters[firstCount++] = static_cast<char>('A' + a);
+        for (int b = 0; b < WordTrie::kAlphabetSize; ++b) {
+            if (trie.child(first, static_cast<char>('A' + b)) != WordTrie::kNoNode) {
+                followers[b] |= 1u << firstIndex;
+                pairs++;
+            }
+        }
+    }
+    if (pairs == 0 || pairs > kMaxPairs) {
+        return false;
+    }
+
+    for (int b = 0; b < WordTrie::kAlphabetSize; ++b) {
+        if (followers[b] != 0) {
+            secondLetters[secondCount++] = { static_cast<char>('A' + b), followers[b] };
+        }
+    }
+    return true;
+}
+
+void CandidateFilter::blockMasks(const Grid& grid, int r, int c,
+    uint32_t masks[kDirectionCount]) const {
+#ifdef CANDIDATE_FILTER_X86
+    blockMasksAvx2(grid, r, c, firstLetters.data(), firstCount, secondLetters.data(), secondCount, masks);
+#else
+    for (int d = 0; d < kDirectionCount; ++d) {
+        masks[d] = 0;
+    }
+#endif
+}
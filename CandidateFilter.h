@@ -0,0 +1,42 @@
+#ifndef CANDIDATE_FILTER_H
+#define CANDIDATE_FILTER_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include "Grid.h"
+#include "GridSearch.h"
+#include "WordTrie.h"
+
+// AVX2 pre-pass for the trie scan on large grids. It compares 32 cells at a
+// time, together with their neighbour in each direction, against the first
+// two letters of every word. Only the cells and directions that survive get a
+// full trie walk. On CPUs without AVX2, build() fails and the scan stays scalar.
+class CandidateFilter {
+public:
+    static constexpr int kBlockWidth = 32;
+    static constexpr int kMaxPairs = 64;
+
+    // Whether this CPU (and OS) can run the AVX2 path; checked once
+    static bool cpuSupported();
+
+    // Collects the first-two-letter prefixes of the trie's words. Returns false
+    // when the filter cannot help: no AVX2, a one-letter word, or more than
+    // kMaxPairs distinct prefixes.
+    bool build(const WordTrie& trie);
+
+    // Bit i of masks[d] is set when cell (r, c + i) and its neighbour in
+    // kDirections[d] spell the start of some word. The 34 columns c-1..c+32
+    // must lie inside the grid.
+    void blockMasks(const Grid& grid, int r, int c, uint32_t masks[kDirectionCount]) const;
+
+private:
+    // Fixed storage, so a scan that builds a filter allocates nothing
+    std::array<char, WordTrie::kAlphabetSize> firstLetters{};
+    int firstCount = 0;
+    // Each second letter with a bitmask of the firstLetters indices it follows
+    std::array<std::pair<char, uint32_t>, WordTrie::kAlphabetSize> secondLetters{};
+    int secondCount = 0;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "Dictionary.h"
+#include <algorithm>
+#include <cctype>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool lessIgnoringCase(std::string_view a, std::string_view b) {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return std::toupper(static_cast<unsigned char>(x)) < std::toupper(static_cast<unsigned char>(y));
+    });
+}
+
+}
+
+Dictionary::~Dictionary() {
+    unmap();
+}
+
+Dictionary& Dictionary::shared() {
+    static Dictionary dictionary;
+    return dictionary;
+}
+
+void Dictionary::unmap() {
+    byLength.clear();
+    wordTotal = 0;
+#ifdef _WIN32
+    if (mapped) UnmapViewOfFile(mapped);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if (mapped) munmap(const_cast<char*>(mapped), mappedSize);
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+bool Dictionary::load(const std::string& path) {
+    unmap();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    mapped = static_cast<const char*>(view);
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping stays valid after the descriptor is closed
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    mapped = static_cast<const char*>(view);
+    mappedSize = static_cast<size_t>(info.st_size);
+#endif
+
+    // Index every all-letter line by length
+    const char* end = mapped + mappedSize;
+    for (const char* line = mapped; line < end;) {
+        const char* lineEnd = std::find(line, end, '\n');
+        const char* wordEnd = lineEnd;
+        while (wordEnd > line && (wordEnd[-1] == '\r' || wordEnd[-1] == ' ')) {
+            wordEnd--;
+        }
+        std::string_view word(line, static_cast<size_t>(wordEnd - line));
+        bool letters = !word.empty() && std::all_of(word.begin(), word.end(), [](char c) {
+            return std::isalpha(static_cast<unsigned char>(c)) != 0;
+        });
+        if (letters) {
+            if (byLength.size() <= word.size()) {
+                byLength.resize(word.size() + 1);
+            }
+            byLength[word.size()].push_back(word);
+            wordTotal++;
+        }
+        line = lineEnd == end ? end : lineEnd + 1;
+    }
+
+    if (wordTotal == 0) {
+        unmap();  // Nothing indexed, so nothing points into the mapping
+        return false;
+    }
+    for (auto& words : byLength) {
+        std::sort(words.begin(), words.end(), lessIgnoringCase);
+    }
+    return true;
+}
+
+bool Dictionary::contains(const std::string& word) const {
+    if (word.size() >= byLength.size()) {
+        return false;
+    }
+    const auto& words = byLength[word.size()];
+    return std::binary_search(words.begin(), words.end(), std::string_view(word), lessIgnoringCase);
+}
+
+size_t Dictionary::countOfLength(int length) const {
+    return length > 0 && static_cast<size_t>(length) < byLength.size() ? byLength[length].size() : 0;
+}
+
+std::string Dictionary::wordOfLength(int length, size_t index) const {
+    std::string word(byLength[length][index]);
+    for (char& c : word) {
+        c = std::toupper(static_cast<unsigned char>(c));
+    }
+    return word;
+}
+
+std::string Dictionary::randomWord(int length, Rng& rng) const {
+    size_t count = countOfLength(length);
+    if (count == 0) {
+        return "";
+    }
+    return wordOfLength(length, rng.below(count));
+}
@@ -0,0 +1,61 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Rng.h"
+
+// Local word list, memory-mapped once at startup and indexed by word length.
+// Validating a word or picking random words of a given length is then an
+// in-process lookup instead of an HTTPS round trip. The file holds one word
+// per line; lines with anything other than letters are skipped.
+class Dictionary {
+public:
+    // Default location, relative to the working directory like output/
+    static constexpr const char* kDefaultPath = "dictionary/words.txt";
+
+    Dictionary() = default;
+    ~Dictionary();
+
+    Dictionary(const Dictionary&) = delete;
+    Dictionary& operator=(const Dictionary&) = delete;
+
+    // Process-wide dictionary used by word fetching and validation
+    static Dictionary& shared();
+
+    // Maps and indexes a word list, replacing any previous one. Returns false
+    // (leaving the dictionary empty) if the file cannot be mapped.
+    bool load(const std::string& path);
+    bool loaded() const { return wordTotal > 0; }
+    size_t size() const { return wordTotal; }
+
+    // Case-insensitive membership test
+    bool contains(const std::string& word) const;
+
+    // Length of the longest word, 0 when nothing is loaded
+    int maxLength() const { return byLength.empty() ? 0 : static_cast<int>(byLength.size()) - 1; }
+
+    // Number of words of one length, and the i'th of them upper-cased
+    size_t countOfLength(int length) const;
+    std::string wordOfLength(int length, size_t index) const;
+
+    // Uniformly random upper-cased word of the given length, or "" if there is none
+    std::string randomWord(int length, Rng& rng) const;
+
+private:
+    void unmap();
+
+    const char* mapped = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+    // Views into the mapping, sorted case-insensitively within each length
+    std::vector<std::vector<std::string_view>> byLength;
+    size_t wordTotal = 0;
+};
+
+#endif
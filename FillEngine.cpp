@@ -0,0 +1,115 @@
+#include "FillEngine.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <numeric>
+#include "AhoCorasick.h"
+#include "GridSearch.h"
+
+namespace {
+
+// Lines scanned forwards: rows, columns and both diagonals. Each one's first
+// cell comes before the rest in row-major order.
+constexpr int kLineCount = 4;
+constexpr Direction kLines[kLineCount] = { {0, 1}, {1, 0}, {1, 1}, {1, -1} };
+
+// Whether the automaton, in state after a letter at (r, c), has completed a
+// word covering (r, c), or will once it reads the placed letters that follow
+// on the line up to the next blank. The walk stops as soon as the partial
+// match no longer reaches back to (r, c).
+bool completesWord(const AhoCorasick& automaton, const Grid& grid, int state, int r, int c, Direction line) {
+    for (int ahead = 0;; ++ahead) {
+        // The first output is the longest word ending here
+        int output = automaton.firstOutput(state);
+        if (output >= 0 && automaton.depth(output) > ahead) {
+            return true;
+        }
+        if (automaton.depth(state) <= ahead) {
+            return false;
+        }
+        r += line.dr;
+        c += line.dc;
+        if (!grid.inBounds(r, c) || grid(r, c) == ' ') {
+            return false;
+        }
+        state = automaton.next(state, grid(r, c));
+    }
+}
+
+}
+
+FillEngine& FillEngine::shared() {
+    static FillEngine engine;
+    return engine;
+}
+
+bool FillEngine::loadBlocklist(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    blocklist.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        bool letters = line.size() >= 3;
+        for (char& ch : line) {
+            letters = letters && std::isalpha(static_cast<unsigned char>(ch));
+            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        }
+        if (letters) {
+            blocklist.push_back(line);
+        }
+    }
+    return true;
+}
+
+size_t FillEngine::fill(Grid& grid, const std::vector<std::string>& targetWords, Rng& rng) const {
+    std::vector<std::string> forbidden = targetWords;
+    forbidden.insert(forbidden.end(), blocklist.begin(), blocklist.end());
+    AhoCorasick automaton(forbidden);
+
+    // Automaton state after each cell of the previous and the current row,
+    // one block of width entries per line direction
+    int width = grid.width();
+    std::vector<int> previous(static_cast<size_t>(kLineCount) * width, automaton.root());
+    std::vector<int> current(previous.size(), automaton.root());
+    size_t unavoidable = 0;
+
+    for (int r = 0; r < grid.height(); ++r) {
+        for (int c = 0; c < width; ++c) {
+            // State just before this cell on each line through it
+            int before[kLineCount];
+            for (int k = 0; k < kLineCount; ++k) {
+                int pr = r - kLines[k].dr;
+                int pc = c - kLines[k].dc;
+                const std::vector<int>& row = pr == r ? current : previous;
+                before[k] = grid.inBounds(pr, pc) ? row[static_cast<size_t>(k) * width + pc] : automaton.root();
+            }
+
+            char& cell = grid(r, c);
+            if (cell == ' ') {
+                // Letters in random order until one is safe on every line
+                char letters[AhoCorasick::kAlphabetSize];
+                std::iota(letters, letters + AhoCorasick::kAlphabetSize, 'A');
+                bool safe = false;
+                for (int i = 0; i < AhoCorasick::kAlphabetSize && !safe; ++i) {
+                    std::swap(letters[i], letters[i + rng.below(AhoCorasick::kAlphabetSize - i)]);
+                    cell = letters[i];
+                    safe = true;
+                    for (int k = 0; k < kLineCount && safe; ++k) {
+                        safe = !completesWord(automaton, grid, automaton.next(before[k], cell), r, c, kLines[k]);
+                    }
+                }
+                unavoidable += safe ? 0 : 1;
+            }
+            for (int k = 0; k < kLineCount; ++k) {
+                current[static_cast<size_t>(k) * width + c] = automaton.next(before[k], cell);
+            }
+        }
+        std::swap(previous, current);
+    }
+    return unavoidable;
+}
@@ -0,0 +1,42 @@
+#ifndef FILL_ENGINE_H
+#define FILL_ENGINE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "Rng.h"
+
+// Fills the cells left blank after placement with random letters that never
+// spell a forbidden word by accident: a second copy of a target word, which
+// would make the puzzle ambiguous, or a word from the blocklist. One
+// Aho-Corasick automaton over both lists (it also holds every word reversed)
+// runs along the rows, columns and both diagonals, which covers all eight
+// directions. Cells are filled in row-major order, so the automaton state
+// before a cell is already known on all four lines through it, and a letter
+// is rejected if it completes a forbidden word there or further along the
+// line through letters already placed. Occurrences made only of placed
+// letters cannot be changed and are left alone. One pass, no backtracking.
+class FillEngine {
+public:
+    // Default location, next to the dictionary
+    static constexpr const char* kDefaultBlocklistPath = "dictionary/blocklist.txt";
+
+    // Process-wide filler used by puzzle generation
+    static FillEngine& shared();
+
+    // Loads words that must never appear, one per line; lines with anything
+    // but letters, or under three letters, are skipped. Call before
+    // generating. Returns false if the file cannot be read.
+    bool loadBlocklist(const std::string& path);
+    size_t blocklistSize() const { return blocklist.size(); }
+
+    // Fills every ' ' cell. Returns the number of cells where every letter
+    // completed a forbidden word; those get a random letter anyway.
+    size_t fill(Grid& grid, const std::vector<std::string>& targetWords, Rng& rng) const;
+
+private:
+    std::vector<std::string> blocklist;  // Upper-cased
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <string>
+#include <vector>
+
+// Letter grid stored row-major in a single buffer. Rows start every stride()
+// bytes, so a directional scan is plain pointer arithmetic and a new puzzle
+// costs one allocation. Accessors do no bounds checking; use inBounds() at
+// the edges of a walk.
+class Grid {
+public:
+    Grid() = default;
+    Grid(int width, int height, char fill = ' ') {
+        reset(width, height, fill);
+    }
+
+    // Builds a grid from equal-length rows of letters (imported puzzles)
+    static Grid fromRows(const std::vector<std::string>& rows) {
+        int height = static_cast<int>(rows.size());
+        int width = height > 0 ? static_cast<int>(rows[0].size()) : 0;
+        Grid grid(width, height);
+        for (int r = 0; r < height; ++r) {
+            rows[r].copy(grid[r], width);
+        }
+        return grid;
+    }
+
+    // Resizes and fills, reusing the existing buffer when it is large enough
+    void reset(int width, int height, char fill = ' ') {
+        gridWidth = width;
+        gridHeight = height;
+        rowStride = width;
+        cells.assign(static_cast<size_t>(rowStride) * height, fill);
+    }
+
+    int width() const { return gridWidth; }
+    int height() const { return gridHeight; }
+    int stride() const { return rowStride; }
+    bool empty() const { return gridWidth == 0 || gridHeight == 0; }
+
+    bool inBounds(int r, int c) const {
+        return r >= 0 && c >= 0 && r < gridHeight && c < gridWidth;
+    }
+
+    char& operator()(int r, int c) { return cells[static_cast<size_t>(r) * rowStride + c]; }
+    char operator()(int r, int c) const { return cells[static_cast<size_t>(r) * rowStride + c]; }
+
+    // Row pointers, so grid[r][c] reads the same as the old nested vectors
+    char* operator[](int r) { return cells.data() + static_cast<size_t>(r) * rowStride; }
+    const char* operator[](int r) const { return cells.data() + static_cast<size_t>(r) * rowStride; }
+
+    char* data() { return cells.data(); }
+    const char* data() const { return cells.data(); }
+
+private:
+    int gridWidth = 0;
+    int gridHeight = 0;
+    int rowStride = 0;
+    std::vector<char> cells;
+};
+
+#endif
@@ -0,0 +1,381 @@
+#include "GridSearch.h"
+#include "CandidateFilter.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+// Opposite of each entry in kDirections, used to turn a reversed match into a
+// hit that starts at the word's first letter
+constexpr uint8_t kOppositeDirection[kDirectionCount] = { 2, 3, 0, 1, 7, 6, 5, 4 };
+
+// Index of a line family's step in kDirections
+uint8_t directionIndex(int dr, int dc) {
+    for (uint8_t d = 0; d < kDirectionCount; ++d) {
+        if (kDirections[d].dr == dr && kDirections[d].dc == dc) {
+            return d;
+        }
+    }
+    return 0;
+}
+
+// Number of cells after (r, c) before a walk in direction (dr, dc) leaves the grid
+int maxSteps(const Grid& grid, int r, int c, int dr, int dc) {
+    int steps = std::max(grid.width(), grid.height());
+    if (dr > 0) steps = std::min(steps, grid.height() - 1 - r);
+    if (dr < 0) steps = std::min(steps, r);
+    if (dc > 0) steps = std::min(steps, grid.width() - 1 - c);
+    if (dc < 0) steps = std::min(steps, c);
+    return steps;
+}
+
+// Follows the trie from (r, c) in one direction, given the node for the
+// letter at (r, c). Returns false if visit asked to stop.
+template <typename Visit>
+bool walkFrom(const Grid& grid, const WordTrie& trie, int r, int c, int d, int first, Visit& visit) {
+    const auto& [dr, dc] = kDirections[d];
+    int steps = maxSteps(grid, r, c, dr, dc);
+    ptrdiff_t step = static_cast<ptrdiff_t>(dr) * grid.stride() + dc;
+    const char* cell = grid[r] + c;
+    int node = first;
+    int len = 1;
+    while (true) {
+        int word = trie.wordAt(node);
+        if (word >= 0 && !visit(word, r, c, d, len)) {
+            return false;
+        }
+        if (len > steps) {
+            return true;
+        }
+        cell += step;
+        node = trie.child(node, *cell);
+        if (node == WordTrie::kNoNode) {
+            return true;
+        }
+        len++;
+    }
+}
+
+// All eight directions from one start cell
+template <typename Visit>
+bool walkCell(const Grid& grid, const WordTrie& trie, int r, int c, Visit& visit) {
+    // Most cells are rejected here without touching their neighbours
+    int first = trie.child(trie.root(), grid[r][c]);
+    if (first == WordTrie::kNoNode) {
+        return true;
+    }
+    for (int d = 0; d < kDirectionCount; ++d) {
+        if (!walkFrom(grid, trie, r, c, d, first, visit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Calls visit(word, row, col, dir, len) for every occurrence starting in rows
+// [rowBegin, rowEnd), in row-major, then direction, then length order, and
+// stops early when visit returns false. Walks may read up to the longest word
+// minus one rows past either end of the range.
+template <typename Visit>
+void scanWithTrie(const Grid& grid, const WordTrie& trie, int rowBegin, int rowEnd, Visit visit) {
+    int rows = grid.height();
+    int cols = grid.width();
+
+    // The AVX2 filter only pays for itself on large grids; blocks need a
+    // spare column on each side for the diagonal neighbour loads
+    const int filterMinCells = 1 << 16;
+    CandidateFilter filter;
+    bool filtered = static_cast<long long>(rows) * cols >= filterMinCells &&
+        cols >= CandidateFilter::kBlockWidth + 2 && filter.build(trie);
+
+    for (int r = rowBegin; r < rowEnd; ++r) {
+        int c = 0;
+        if (filtered) {
+            if (!walkCell(grid, trie, r, c++, visit)) {
+                return;
+            }
+            uint32_t masks[kDirectionCount];
+            for (; c + CandidateFilter::kBlockWidth < cols; c += CandidateFilter::kBlockWidth) {
+                filter.blockMasks(grid, r, c, masks);
+                uint32_t any = 0;
+                for (uint32_t mask : masks) {
+                    any |= mask;
+                }
+                for (; any != 0; any &= any - 1) {
+                    int bit = lowestSetBit(any);
+                    int first = trie.child(trie.root(), grid[r][c + bit]);
+                    for (int d = 0; d < kDirectionCount; ++d) {
+                        if (((masks[d] >> bit) & 1) && !walkFrom(grid, trie, r, c + bit, d, first, visit)) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+        for (; c < cols; ++c) {
+            if (!walkCell(grid, trie, r, c, visit)) {
+                return;
+            }
+        }
+    }
+}
+
+// Runs the automaton along every row, column, diagonal and anti-diagonal in
+// place, treating each as a projected line read from its top/left end, and
+// reports the matches whose last cell read lies in rows [rowBegin, rowEnd).
+// Lines crossing the range are started longest-pattern-minus-one rows early
+// so the automaton state is exact by the time reporting begins.
+template <typename Visit>
+void scanWithAhoCorasick(const Grid& grid, const AhoCorasick& automaton, int rowBegin, int rowEnd,
+    Visit visit) {
+    int rows = grid.height();
+    int cols = grid.width();
+    int warmUp = std::max(0, automaton.maxPatternLength() - 1);
+
+    // Reads count cells from (r, c), reporting from the reportFrom'th onwards
+    auto scanLine = [&](int r, int c, int dr, int dc, int count, int reportFrom) {
+        uint8_t forward = directionIndex(dr, dc);
+        ptrdiff_t step = static_cast<ptrdiff_t>(dr) * grid.stride() + dc;
+        const char* cell = grid[r] + c;
+        int state = automaton.root();
+        for (int i = 0; i < count; ++i, cell += step, r += dr, c += dc) {
+            state = automaton.next(state, *cell);
+            if (i < reportFrom) {
+                continue;
+            }
+            for (int out = automaton.firstOutput(state); out >= 0; out = automaton.nextOutput(out)) {
+                int len = automaton.depth(out);
+                for (int m = automaton.firstMatch(out); m >= 0; m = automaton.match(m).next) {
+                    const AhoCorasick::Match& match = automaton.match(m);
+                    bool keepGoing = match.reversed
+                        ? visit(match.word, r, c, kOppositeDirection[forward], len)
+                        : visit(match.word, r - (len - 1) * dr, c - (len - 1) * dc, forward, len);
+                    if (!keepGoing) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    // Downward line segment covering rows [first, last] of the line, started
+    // early for warm-up but never above the line's own first row
+    auto scanDownward = [&](int firstRow, int lastRow, int colAtRow0, int dc) {
+        int start = std::max(firstRow, rowBegin - warmUp);
+        int end = std::min(lastRow + 1, rowEnd);
+        if (end <= start || end <= rowBegin) {
+            return true;
+        }
+        return scanLine(start, colAtRow0 + start * dc, 1, dc, end - start,
+            std::max(0, rowBegin - start));
+    };
+
+    if (grid.empty() || rowBegin >= rowEnd) {
+        return;
+    }
+    // Rows, columns, then diagonals and anti-diagonals from their top end
+    for (int r = rowBegin; r < rowEnd; ++r) {
+        if (!scanLine(r, 0, 0, 1, cols, 0)) return;
+    }
+    for (int c = 0; c < cols; ++c) {
+        if (!scanDownward(0, rows - 1, c, 0)) return;
+    }
+    for (int k = -(rows - 1); k < cols; ++k) {
+        // Cells (r, r + k)
+        if (!scanDownward(std::max(0, -k), std::min(rows, cols - k) - 1, k, 1)) return;
+    }
+    for (int k = 0; k < rows + cols - 1; ++k) {
+        // Cells (r, k - r)
+        if (!scanDownward(std::max(0, k - (cols - 1)), std::min(rows - 1, k), k, -1)) return;
+    }
+}
+
+// Visitor that flags each word once and stops when all have been seen
+struct FoundVisitor {
+    std::vector<bool>& found;
+    int remaining;
+
+    bool operator()(int word, int, int, int, int) {
+        if (!found[word]) {
+            found[word] = true;
+            remaining--;
+        }
+        return remaining > 0;
+    }
+};
+
+// FoundVisitor shared by concurrent bands; every band stops once all words
+// have been seen by any of them
+struct SharedFoundVisitor {
+    std::vector<std::atomic<bool>>& found;
+    std::atomic<int>& remaining;
+
+    bool operator()(int word, int, int, int, int) {
+        if (!found[word].load(std::memory_order_relaxed) && !found[word].exchange(true)) {
+            remaining--;
+        }
+        return remaining.load(std::memory_order_relaxed) > 0;
+    }
+};
+
+// Visitor that appends hits to a fixed buffer and keeps counting past its end
+struct HitVisitor {
+    WordHit* hits;
+    size_t capacity;
+    size_t count;
+
+    bool operator()(int word, int row, int col, int dir, int len) {
+        if (count < capacity) {
+            hits[count] = { static_cast<uint32_t>(word), static_cast<uint32_t>(row),
+                static_cast<uint32_t>(col), static_cast<uint16_t>(len), static_cast<uint8_t>(dir) };
+        }
+        count++;
+        return true;
+    }
+};
+
+// Whether a grid is big enough to split into bands, and how many rows each gets
+bool useBands(const Grid& grid) {
+    return static_cast<long long>(grid.width()) * grid.height() >= kParallelMinCells &&
+        ThreadPool::shared().size() > 1;
+}
+
+// Upper bound on bands, so per-band bookkeeping fits in fixed arrays
+constexpr int kMaxBands = 256;
+
+int bandCount(const Grid& grid) {
+    // A few bands per thread so stealing can even out bands with many hits
+    const int minBandRows = 32;
+    int bands = std::min(static_cast<int>(ThreadPool::shared().size()) * 4, kMaxBands);
+    return std::max(1, std::min(bands, grid.height() / minBandRows));
+}
+
+// Scans every band on the shared pool. Each band owns the start rows (trie) or
+// end rows (Aho-Corasick) in its range and reads across its edges, so a match
+// that crosses a band boundary is found exactly once. Bands before firstBand
+// are skipped.
+template <typename ScanRange>
+void scanBands(const Grid& grid, ScanRange scanRange, int firstBand = 0) {
+    int bands = bandCount(grid);
+    int rows = grid.height();
+    ThreadPool::shared().parallelFor(bands - firstBand, [&](size_t index) {
+        size_t band = firstBand + index;
+        int rowBegin = static_cast<int>(rows * band / bands);
+        int rowEnd = static_cast<int>(rows * (band + 1) / bands);
+        scanRange(band, rowBegin, rowEnd);
+    });
+}
+
+template <typename ScanRange>
+void findWordsInBands(const Grid& grid, int uniqueWords, std::vector<bool>& found, ScanRange scanRange) {
+    std::vector<std::atomic<bool>> shared(found.size());
+    std::atomic<int> remaining{ uniqueWords };
+    scanBands(grid, [&](size_t, int rowBegin, int rowEnd) {
+        scanRange(rowBegin, rowEnd, SharedFoundVisitor{ shared, remaining });
+    });
+    for (size_t i = 0; i < found.size(); ++i) {
+        found[i] = shared[i].load();
+    }
+}
+
+// Each band writes straight into an equal slice of the caller's buffer and
+// counts past its end; the slices are then packed down in band order, so the
+// result does not depend on which thread finished first. Only when a band
+// overflowed its slice are it and the bands after it scanned again, this time
+// at their exact offsets, which the first pass has already counted.
+template <typename ScanRange>
+size_t findHitsInBands(const Grid& grid, WordHit* hits, size_t capacity, ScanRange scanRange) {
+    int bands = bandCount(grid);
+    size_t sliceSize = capacity / bands;
+    size_t bandHits[kMaxBands];
+    scanBands(grid, [&](size_t band, int rowBegin, int rowEnd) {
+        HitVisitor visitor{ hits + band * sliceSize, sliceSize, 0 };
+        scanRange(rowBegin, rowEnd, std::ref(visitor));
+        bandHits[band] = visitor.count;
+    });
+
+    size_t offsets[kMaxBands];
+    size_t total = 0;
+    int firstOverflow = bands;
+    for (int band = 0; band < bands; ++band) {
+        offsets[band] = total;
+        total += bandHits[band];
+        if (firstOverflow == bands && bandHits[band] > sliceSize) {
+            firstOverflow = band;
+        }
+        if (firstOverflow == bands && offsets[band] != band * sliceSize) {
+            // Never past the band's own slice, since every earlier band fit in its slice
+            std::memmove(hits + offsets[band], hits + band * sliceSize, bandHits[band] * sizeof(WordHit));
+        }
+    }
+    if (firstOverflow < bands) {
+        scanBands(grid, [&](size_t band, int rowBegin, int rowEnd) {
+            if (offsets[band] < capacity) {
+                HitVisitor visitor{ hits + offsets[band], capacity - offsets[band], 0 };
+                scanRange(rowBegin, rowEnd, std::ref(visitor));
+            }
+        }, firstOverflow);
+    }
+    return total;
+}
+
+}
+
+void findWordsWithTrie(const Grid& grid, const WordTrie& trie,
+    std::vector<bool>& found) {
+    found.assign(trie.wordCount(), false);
+    if (trie.uniqueWordCount() == 0) {
+        return;
+    }
+    if (useBands(grid)) {
+        findWordsInBands(grid, trie.uniqueWordCount(), found, [&](int rowBegin, int rowEnd, auto visit) {
+            scanWithTrie(grid, trie, rowBegin, rowEnd, visit);
+        });
+        return;
+    }
+    scanWithTrie(grid, trie, 0, grid.height(), FoundVisitor{ found, trie.uniqueWordCount() });
+}
+
+size_t findHitsWithTrie(const Grid& grid, const WordTrie& trie,
+    WordHit* hits, size_t capacity) {
+    if (useBands(grid)) {
+        return findHitsInBands(grid, hits, capacity, [&](int rowBegin, int rowEnd, auto visit) {
+            scanWithTrie(grid, trie, rowBegin, rowEnd, visit);
+        });
+    }
+    HitVisitor visitor{ hits, capacity, 0 };
+    scanWithTrie(grid, trie, 0, grid.height(), std::ref(visitor));
+    return visitor.count;
+}
+
+void findWordsWithAhoCorasick(const Grid& grid,
+    const AhoCorasick& automaton, std::vector<bool>& found) {
+    found.assign(automaton.wordCount(), false);
+    if (automaton.uniqueWordCount() == 0) {
+        return;
+    }
+    if (useBands(grid)) {
+        findWordsInBands(grid, automaton.uniqueWordCount(), found, [&](int rowBegin, int rowEnd, auto visit) {
+            scanWithAhoCorasick(grid, automaton, rowBegin, rowEnd, visit);
+        });
+        return;
+    }
+    scanWithAhoCorasick(grid, automaton, 0, grid.height(),
+        FoundVisitor{ found, automaton.uniqueWordCount() });
+}
+
+size_t findHitsWithAhoCorasick(const Grid& grid,
+    const AhoCorasick& automaton, WordHit* hits, size_t capacity) {
+    if (useBands(grid)) {
+        return findHitsInBands(grid, hits, capacity, [&](int rowBegin, int rowEnd, auto visit) {
+            scanWithAhoCorasick(grid, automaton, rowBegin, rowEnd, visit);
+        });
+    }
+    HitVisitor visitor{ hits, capacity, 0 };
+    scanWithAhoCorasick(grid, automaton, 0, grid.height(), std::ref(visitor));
+    return visitor.count;
+}
@@ -0,0 +1,77 @@
+#ifndef GRID_SEARCH_H
+#define GRID_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "AhoCorasick.h"
+#include "Grid.h"
+#include "WordTrie.h"
+
+// Row/column step for each of the eight reading directions, in the order
+// placeWordInGrid has always tried them
+struct Direction {
+    int dr;
+    int dc;
+};
+
+inline constexpr int kDirectionCount = 8;
+inline constexpr Direction kDirections[kDirectionCount] = {
+    {0, 1}, {1, 0}, {0, -1}, {-1, 0}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+};
+inline constexpr const char* kDirectionNames[kDirectionCount] = {
+    "right", "down", "left", "up", "down-right", "down-left", "up-right", "up-left"
+};
+
+// Grids with at least this many cells are split into row bands and scanned on
+// the shared thread pool (when it has more than one worker)
+inline constexpr long long kParallelMinCells = 1 << 20;
+
+// Index of the lowest set bit; bits must be non-zero
+inline int lowestSetBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// One occurrence of a word: start cell, index into kDirections and length.
+// wordIndex is the canonical index (first word in the list with that spelling).
+struct WordHit {
+    uint32_t wordIndex;
+    uint32_t row;
+    uint32_t col;
+    uint16_t len;
+    uint8_t dir;
+};
+
+// Scans every cell in all eight directions, walking only the prefixes that are
+// live in the trie, and sets found[i] for each trie word that occurs in the grid.
+// found is indexed by the trie's canonical word index.
+void findWordsWithTrie(const Grid& grid, const WordTrie& trie,
+    std::vector<bool>& found);
+
+// Same scan, reporting every occurrence into a caller-provided buffer. Hits are
+// never staged anywhere else; the only allocations are the thread pool's
+// per-band tasks on grids split into bands. Returns the total number of hits;
+// only the first capacity are written, so a caller can retry with a larger buffer.
+size_t findHitsWithTrie(const Grid& grid, const WordTrie& trie,
+    WordHit* hits, size_t capacity);
+
+// Projects the grid into its rows, columns, diagonals and anti-diagonals and
+// runs the automaton once over each line. Reversed patterns cover the other
+// four directions, so the cost is linear in cells plus matches regardless of
+// how many words there are. found is indexed by canonical word index.
+void findWordsWithAhoCorasick(const Grid& grid,
+    const AhoCorasick& automaton, std::vector<bool>& found);
+
+size_t findHitsWithAhoCorasick(const Grid& grid,
+    const AhoCorasick& automaton, WordHit* hits, size_t capacity);
+
+#endif
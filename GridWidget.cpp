@@ -0,0 +1,173 @@
+#include "GridWidget.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+const ImVec4 kSelectedColor(0.2f, 0.8f, 0.2f, 1.0f);
+
+float gapFor(float pitch) {
+    return pitch >= GridWidget::kMinGapPitch ? pitch / 11.0f : 0.0f;
+}
+
+// Cell under a point in board pixels; false in the gaps between cells
+bool cellAt(ImVec2 point, float pitch, int rows, int cols, int& row, int& col) {
+    if (point.x < 0 || point.y < 0) {
+        return false;
+    }
+    col = static_cast<int>(point.x / pitch);
+    row = static_cast<int>(point.y / pitch);
+    float cellSize = pitch - gapFor(pitch);
+    return row < rows && col < cols &&
+        point.x - col * pitch < cellSize && point.y - row * pitch < cellSize;
+}
+
+}
+
+bool GridWidget::draw(const Grid& grid, const CellState* cells, const ImVec4* palette, SelectableFn selectable,
+    int& clickedRow, int& clickedCol) {
+    int rows = grid.height();
+    int cols = grid.width();
+    if (rows == 0 || cols == 0) {
+        return false;
+    }
+
+    // A new board starts fitted to the width, within the initial pitch range
+    float availWidth = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+    if (rows != viewRows || cols != viewCols || pitch == 0.0f) {
+        viewRows = rows;
+        viewCols = cols;
+        pitch = std::clamp(availWidth / cols, kMinInitialPitch, kMaxCellPitch);
+        scroll = ImVec2(0, 0);
+    }
+
+    const ImGuiStyle& style = ImGui::GetStyle();
+    ImGuiIO& io = ImGui::GetIO();
+    auto boardSize = [&] {
+        return ImVec2(cols * pitch - gapFor(pitch), rows * pitch - gapFor(pitch));
+    };
+    ImVec2 board = boardSize();
+    ImVec2 viewSize(std::min(board.x, availWidth), std::min(board.y, availWidth));
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    bool pressed = ImGui::InvisibleButton("##GridView", viewSize,
+        ImGuiButtonFlags_MouseButtonLeft | ImGuiButtonFlags_MouseButtonRight | ImGuiButtonFlags_MouseButtonMiddle);
+    bool hovered = ImGui::IsItemHovered();
+    bool held = ImGui::IsItemActive();
+    ImGui::SetItemKeyOwner(ImGuiKey_MouseWheelY);  // The wheel zooms instead of scrolling the page
+    ImVec2 mouse(io.MousePos.x - origin.x, io.MousePos.y - origin.y);
+
+    // Zoom around the board point under the cursor, then pan
+    if (hovered && io.MouseWheel != 0.0f) {
+        ImVec2 anchor((mouse.x + scroll.x) / pitch, (mouse.y + scroll.y) / pitch);
+        pitch = std::clamp(pitch * std::pow(1.2f, io.MouseWheel), kMinZoomPitch, kMaxZoomPitch);
+        scroll = ImVec2(anchor.x * pitch - mouse.x, anchor.y * pitch - mouse.y);
+        board = boardSize();
+    }
+    if (held && (ImGui::IsMouseDown(ImGuiMouseButton_Right) || ImGui::IsMouseDown(ImGuiMouseButton_Middle))) {
+        scroll.x -= io.MouseDelta.x;
+        scroll.y -= io.MouseDelta.y;
+    }
+    scroll.x = std::clamp(scroll.x, 0.0f, std::max(0.0f, board.x - viewSize.x));
+    scroll.y = std::clamp(scroll.y, 0.0f, std::max(0.0f, board.y - viewSize.y));
+    partial = board.x > viewSize.x || board.y > viewSize.y;
+
+    float gap = gapFor(pitch);
+    float cellSize = pitch - gap;
+    ImVec2 pointer(mouse.x + scroll.x, mouse.y + scroll.y);
+    int hoverRow = -1;
+    int hoverCol = -1;
+    if (hovered && !cellAt(pointer, pitch, rows, cols, hoverRow, hoverCol)) {
+        hoverRow = hoverCol = -1;
+    }
+
+    // Visible cell window, from the scroll offset and the viewport size
+    int rowBegin = std::min(rows, static_cast<int>(scroll.y / pitch));
+    int rowEnd = std::min(rows, static_cast<int>(std::ceil((scroll.y + viewSize.y) / pitch)));
+    int colBegin = std::min(cols, static_cast<int>(scroll.x / pitch));
+    int colEnd = std::min(cols, static_cast<int>(std::ceil((scroll.x + viewSize.x) / pitch)));
+    ImVec2 base(origin.x - scroll.x, origin.y - scroll.y);  // Screen position of cell (0, 0)
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->PushClipRect(origin, ImVec2(origin.x + viewSize.x, origin.y + viewSize.y), true);
+    ImU32 buttonColor = ImGui::GetColorU32(ImGuiCol_Button);
+    ImU32 selectedColor = ImGui::GetColorU32(kSelectedColor);
+
+    long long visibleCells = static_cast<long long>(rowEnd - rowBegin) * (colEnd - colBegin);
+    if (visibleCells > kMaxDetailCells) {
+        // Overview: one background, then found and selected cells as row runs
+        drawList->AddRectFilled(origin, ImVec2(origin.x + viewSize.x, origin.y + viewSize.y), buttonColor);
+        int runsLeft = kMaxDetailCells;
+        for (int r = rowBegin; r < rowEnd && runsLeft > 0; ++r) {
+            const CellState* states = cells + static_cast<size_t>(r) * cols;
+            float top = base.y + r * pitch;
+            for (int c = colBegin; c < colEnd && runsLeft > 0;) {
+                CellState state = states[c];
+                if (state.flags == 0) {
+                    c++;
+                    continue;
+                }
+                int runEnd = c + 1;
+                while (runEnd < colEnd && states[runEnd].flags == state.flags &&
+                    states[runEnd].palette == state.palette) {
+                    runEnd++;
+                }
+                ImU32 fill = state.flags & CellUsed ? ImGui::GetColorU32(palette[state.palette]) : selectedColor;
+                drawList->AddRectFilled(ImVec2(base.x + c * pitch, top),
+                    ImVec2(base.x + runEnd * pitch - gap, top + cellSize), fill);
+                runsLeft--;
+                c = runEnd;
+            }
+        }
+    }
+    else {
+        ImU32 disabledColor = ImGui::GetColorU32(ImGuiCol_Button, style.DisabledAlpha);
+        ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+        ImU32 disabledTextColor = ImGui::GetColorU32(ImGuiCol_Text, style.DisabledAlpha);
+        ImU32 hoverColor = ImGui::GetColorU32(held ? ImGuiCol_ButtonActive : ImGuiCol_ButtonHovered);
+        ImFont* font = ImGui::GetFont();
+        float fontSize = std::min(ImGui::GetFontSize(), cellSize * 0.75f);
+        bool glyphs = cellSize >= kMinGlyphSize;
+        float rounding = std::min(style.FrameRounding, cellSize * 0.25f);
+
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            const char* row = grid[r];
+            const CellState* states = cells + static_cast<size_t>(r) * cols;
+            for (int c = colBegin; c < colEnd; ++c) {
+                CellState state = states[c];
+                bool clickable = state.flags != 0 || selectable(r, c);
+                ImU32 fill;
+                if (state.flags & CellUsed) {
+                    fill = ImGui::GetColorU32(palette[state.palette]);
+                }
+                else if (state.flags & CellSelected) {
+                    fill = selectedColor;
+                }
+                else if (!clickable) {
+                    fill = disabledColor;
+                }
+                else {
+                    fill = r == hoverRow && c == hoverCol ? hoverColor : buttonColor;
+                }
+
+                ImVec2 topLeft(base.x + c * pitch, base.y + r * pitch);
+                drawList->AddRectFilled(topLeft, ImVec2(topLeft.x + cellSize, topLeft.y + cellSize), fill, rounding);
+                if (glyphs) {
+                    ImVec2 glyph = font->CalcTextSizeA(fontSize, FLT_MAX, 0.0f, row + c, row + c + 1);
+                    drawList->AddText(font, fontSize,
+                        ImVec2(topLeft.x + (cellSize - glyph.x) * 0.5f, topLeft.y + (cellSize - glyph.y) * 0.5f),
+                        clickable ? textColor : disabledTextColor, row + c, row + c + 1);
+                }
+            }
+        }
+    }
+    drawList->PopClipRect();
+
+    // Only a left click selects; right and middle buttons pan
+    if (!pressed || !ImGui::IsMouseReleased(ImGuiMouseButton_Left) ||
+        !cellAt(pointer, pitch, rows, cols, clickedRow, clickedCol)) {
+        return false;
+    }
+    const CellState& state = cells[static_cast<size_t>(clickedRow) * cols + clickedCol];
+    return state.flags != 0 || selectable(clickedRow, clickedCol);
+}
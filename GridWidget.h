@@ -0,0 +1,60 @@
+#ifndef GRID_WIDGET_H
+#define GRID_WIDGET_H
+
+#include <cstdint>
+#include <imgui.h>
+#include "Grid.h"
+
+// Per-cell render state, row-major like the grid. The game updates it only
+// when the selection or the found words change, so drawing a cell is a
+// single lookup.
+enum CellFlag : uint8_t {
+    CellUsed = 1 << 0,      // Part of a found word; palette holds its color
+    CellSelected = 1 << 1   // Part of the current selection
+};
+struct CellState {
+    uint8_t flags = 0;
+    uint8_t palette = 0;    // Index into the palette for used cells
+};
+
+// Pannable, zoomable board view drawn through the window's ImDrawList. Only
+// the cells inside the viewport are visited, so the cost of a frame depends
+// on the viewport and zoom, not on the grid size. Clicks are hit-tested from
+// the mouse position and reported in full-grid coordinates.
+//
+// Level of detail: letters are drawn only when cells are large enough to
+// read; when more cells are visible than a draw list can hold, plain cells
+// collapse into one background and only found or selected cells are drawn,
+// merged into runs along each row.
+class GridWidget {
+public:
+    static constexpr float kMaxCellPitch = 44.0f;       // Cell plus gap when a board first shows
+    static constexpr float kMinInitialPitch = 16.0f;    // Larger boards start here and pan
+    static constexpr float kMinZoomPitch = 0.5f;
+    static constexpr float kMaxZoomPitch = 96.0f;
+    static constexpr float kMinGapPitch = 8.0f;         // Cells touch below this
+    static constexpr float kMinGlyphSize = 9.0f;        // Smallest cell that gets its letter
+    static constexpr int kMaxDetailCells = 12000;       // About 48k vertices of rectangles
+
+    // Whether a plain (not used, not selected) cell may be clicked
+    using SelectableFn = bool (*)(int row, int col);
+
+    // Draws the grid at the cursor, using the available width and at most as
+    // much height. Mouse wheel zooms around the cursor, right or middle drag
+    // pans. Used and selected cells are always clickable, others only if
+    // selectable() allows it. Returns true and the cell if one was clicked.
+    bool draw(const Grid& grid, const CellState* cells, const ImVec4* palette, SelectableFn selectable,
+        int& clickedRow, int& clickedCol);
+
+    // Whether the last frame showed only part of the board
+    bool clipped() const { return partial; }
+
+private:
+    float pitch = 0.0f;         // Cell size plus gap, in pixels; 0 until the first draw
+    ImVec2 scroll;              // Board pixel at the viewport's top-left corner
+    int viewRows = 0;           // Board the view state belongs to
+    int viewCols = 0;
+    bool partial = false;
+};
+
+#endif
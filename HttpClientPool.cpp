@@ -0,0 +1,68 @@
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#define NOMINMAX
+#include "HttpClientPool.h"
+#include "httplib.h"
+#include <utility>
+
+HttpClientPool::Lease::Lease(HttpClientPool* pool, std::string host, httplib::SSLClient* client)
+    : pool(pool), host(std::move(host)), client(client) {
+}
+
+HttpClientPool::Lease::Lease(Lease&& other) noexcept
+    : pool(other.pool), host(std::move(other.host)), client(other.client) {
+    other.client = nullptr;
+}
+
+HttpClientPool::Lease::~Lease() {
+    if (client) {
+        pool->release(host, client);
+    }
+}
+
+void HttpClientPool::Lease::discard() {
+    delete client;
+    client = nullptr;
+}
+
+HttpClientPool::~HttpClientPool() {
+    for (auto& [host, clients] : idle) {
+        for (httplib::SSLClient* client : clients) {
+            delete client;
+        }
+    }
+}
+
+HttpClientPool& HttpClientPool::shared() {
+    static HttpClientPool pool;
+    return pool;
+}
+
+HttpClientPool::Lease HttpClientPool::acquire(const std::string& host) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& clients = idle[host];
+        if (!clients.empty()) {
+            httplib::SSLClient* client = clients.back();
+            clients.pop_back();
+            return Lease(this, host, client);
+        }
+    }
+
+    auto* client = new httplib::SSLClient(host.c_str());
+    client->set_connection_timeout(3, 0);
+    client->set_read_timeout(3, 0);
+    client->set_keep_alive(true);
+    return Lease(this, host, client);
+}
+
+void HttpClientPool::release(const std::string& host, httplib::SSLClient* client) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& clients = idle[host];
+        if (clients.size() < kMaxIdlePerHost) {
+            clients.push_back(client);
+            return;
+        }
+    }
+    delete client;
+}
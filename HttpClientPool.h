@@ -0,0 +1,64 @@
+#ifndef HTTP_CLIENT_POOL_H
+#define HTTP_CLIENT_POOL_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace httplib {
+class SSLClient;
+}
+
+// Long-lived keep-alive HTTPS clients, pooled per host and shared by word
+// fetching and validation. A client keeps its TLS connection open between
+// requests, so only the first request on each pooled client pays for the
+// TCP and TLS handshakes.
+class HttpClientPool {
+public:
+    // Idle clients kept per host; enough for every request that can be in
+    // flight at once: up to 12 validation requests from each of four
+    // generators (the foreground puzzle and one refill per pool size)
+    static constexpr size_t kMaxIdlePerHost = 64;
+
+    // Exclusive use of one client; returns it to the pool when destroyed
+    class Lease {
+    public:
+        Lease(HttpClientPool* pool, std::string host, httplib::SSLClient* client);
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        httplib::SSLClient* operator->() const { return client; }
+        httplib::SSLClient& operator*() const { return *client; }
+
+        // Drops the client instead of pooling it, e.g. after a failed request
+        void discard();
+
+    private:
+        HttpClientPool* pool;
+        std::string host;
+        httplib::SSLClient* client;
+    };
+
+    HttpClientPool() = default;
+    ~HttpClientPool();
+
+    HttpClientPool(const HttpClientPool&) = delete;
+    HttpClientPool& operator=(const HttpClientPool&) = delete;
+
+    static HttpClientPool& shared();
+
+    // An idle client for the host, or a new one if all are in use
+    Lease acquire(const std::string& host);
+
+private:
+    void release(const std::string& host, httplib::SSLClient* client);
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<httplib::SSLClient*>> idle;
+};
+
+#endif
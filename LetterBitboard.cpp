@@ -0,0 +1,87 @@
+#include "LetterBitboard.h"
+#include <algorithm>
+
+bool LetterBitboard::build(const Grid& grid) {
+    if (grid.width() > kMaxWidth) {
+        boardWidth = boardHeight = 0;
+        widthMask = 0;
+        masks.clear();
+        return false;
+    }
+
+    boardWidth = grid.width();
+    boardHeight = grid.height();
+    widthMask = boardWidth == kMaxWidth ? ~0ULL : (1ULL << boardWidth) - 1;
+    masks.assign(static_cast<size_t>(boardHeight) * kAlphabetSize, 0);
+    for (int r = 0; r < boardHeight; ++r) {
+        const char* row = grid[r];
+        uint64_t* rowMasks = &masks[static_cast<size_t>(r) * kAlphabetSize];
+        for (int c = 0; c < boardWidth; ++c) {
+            unsigned index = static_cast<unsigned char>(row[c]) - 'A';
+            if (index < kAlphabetSize) {
+                rowMasks[index] |= 1ULL << c;
+            }
+        }
+    }
+    return true;
+}
+
+uint64_t LetterBitboard::matchRow(const std::string& word, int r, int dir) const {
+    const auto& [dr, dc] = kDirections[dir];
+    int len = static_cast<int>(word.length());
+    int lastRow = r + (len - 1) * dr;
+    if (len == 0 || lastRow < 0 || lastRow >= boardHeight || (dc != 0 && len > boardWidth)) {
+        return 0;
+    }
+
+    // Letter k sits k columns right (or left) of the start, so shifting its
+    // mask back by k lines it up with the start column. Bits shifted in from
+    // outside the row are zero, which rules out starts too close to the edge.
+    uint64_t starts = widthMask;
+    for (int k = 0; k < len && starts != 0; ++k) {
+        uint64_t letter = mask(r + k * dr, word[k]);
+        if (dc > 0) {
+            letter >>= k;
+        }
+        else if (dc < 0) {
+            letter = (letter << k) & widthMask;
+        }
+        starts &= letter;
+    }
+    return starts;
+}
+
+bool LetterBitboard::contains(const std::string& word) const {
+    if (word.empty()) {
+        return false;
+    }
+    for (int r = 0; r < boardHeight; ++r) {
+        if (mask(r, word[0]) == 0) {
+            continue;  // No start cell in this row for any direction
+        }
+        for (int d = 0; d < kDirectionCount; ++d) {
+            if (matchRow(word, r, d) != 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int LetterBitboard::countOccurrences(const std::string& word) const {
+    // Left, up, up-right and up-left read right, down, down-left and down-right
+    // backwards, so a palindrome is only looked for in the latter four
+    bool palindrome = std::equal(word.begin(), word.begin() + word.size() / 2, word.rbegin());
+    int count = 0;
+    for (int d = 0; d < kDirectionCount; ++d) {
+        if (palindrome && d != 0 && d != 1 && d != 4 && d != 5) {
+            continue;
+        }
+        for (int r = 0; r < boardHeight; ++r) {
+            for (uint64_t starts = matchRow(word, r, d); starts != 0; starts &= starts - 1) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
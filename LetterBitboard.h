@@ -0,0 +1,46 @@
+#ifndef LETTER_BITBOARD_H
+#define LETTER_BITBOARD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "GridSearch.h"
+
+// For grids up to 64 columns: 26 masks per row, bit c of mask(r, letter) set
+// when cell (r, c) holds that letter. A word in any direction is then matched
+// for a whole row of start cells at once by shifting and ANDing one mask per
+// letter, instead of comparing cell by cell.
+class LetterBitboard {
+public:
+    static constexpr int kMaxWidth = 64;
+    static constexpr int kAlphabetSize = 26;
+
+    LetterBitboard() = default;
+
+    // Returns false (and leaves the board empty) when the grid is wider than 64
+    bool build(const Grid& grid);
+
+    int width() const { return boardWidth; }
+    int height() const { return boardHeight; }
+
+    uint64_t mask(int r, char letter) const {
+        unsigned index = static_cast<unsigned char>(letter) - 'A';
+        return index < kAlphabetSize ? masks[static_cast<size_t>(r) * kAlphabetSize + index] : 0;
+    }
+
+    // Bit c is set when the word starts at (r, c) reading in kDirections[dir]
+    uint64_t matchRow(const std::string& word, int r, int dir) const;
+
+    bool contains(const std::string& word) const;
+    // Distinct occurrences; a palindrome read both ways over the same cells counts once
+    int countOccurrences(const std::string& word) const;
+
+private:
+    int boardWidth = 0;
+    int boardHeight = 0;
+    uint64_t widthMask = 0;
+    std::vector<uint64_t> masks;
+};
+
+#endif
@@ -0,0 +1,461 @@
+#include "PlacementEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include "GridSearch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLACEMENT_ENGINE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Scores count consecutive start cells of one row for a word whose letters
+// are step bytes apart in the grid. For each start: whether it clashes with a
+// placed letter, how many of its letters are already there, and how many of
+// its new letters land on a touching cell (near is null when not needed).
+// Counts saturate at 255.
+void scoreRun(const char* cells, const char* near, ptrdiff_t step, const std::string& word, int count,
+    uint8_t* blocked, uint8_t* shared, uint8_t* touching) {
+    int c = 0;
+#ifdef PLACEMENT_ENGINE_SSE2
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i allSet = _mm_set1_epi8(-1);
+    for (; c < count && count >= 16; c += 16) {
+        c = std::min(c, count - 16);  // The last block overlaps the previous one instead of a scalar tail
+        __m128i clash = _mm_setzero_si128();
+        __m128i same = _mm_setzero_si128();
+        __m128i touch = _mm_setzero_si128();
+        const char* cell = cells + c;
+        const char* nearCell = near ? near + c : nullptr;
+        for (char letter : word) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cell));
+            __m128i eq = _mm_cmpeq_epi8(v, _mm_set1_epi8(letter));
+            __m128i open = _mm_or_si128(eq, _mm_cmpeq_epi8(v, blank));
+            clash = _mm_or_si128(clash, _mm_xor_si128(open, allSet));
+            same = _mm_adds_epu8(same, _mm_and_si128(eq, ones));
+            if (nearCell) {
+                __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nearCell));
+                touch = _mm_adds_epu8(touch, _mm_and_si128(n, ones));
+                nearCell += step;
+            }
+            cell += step;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(blocked + c), clash);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(shared + c), same);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(touching + c), touch);
+    }
+#endif
+    for (; c < count; ++c) {
+        uint8_t clash = 0;
+        unsigned same = 0;
+        unsigned touch = 0;
+        const char* cell = cells + c;
+        const char* nearCell = near ? near + c : nullptr;
+        for (char letter : word) {
+            clash |= *cell != ' ' && *cell != letter;
+            same += *cell == letter;
+            if (nearCell) {
+                touch += *nearCell != 0;
+                nearCell += step;
+            }
+            cell += step;
+        }
+        blocked[c] = clash;
+        shared[c] = static_cast<uint8_t>(std::min(same, 255u));
+        touching[c] = static_cast<uint8_t>(std::min(touch, 255u));
+    }
+}
+
+}
+
+PlacementEngine::PlacementEngine(size_t nodeBudget)
+    : nodeBudget(nodeBudget) {
+}
+
+void PlacementEngine::preferOverlap(float newTemperature, float newAdjacencyPenalty) {
+    overlap = true;
+    temperature = newTemperature;
+    adjacencyPenalty = newAdjacencyPenalty;
+}
+
+// Letters only: slots come from the SlotTable, so they are always in bounds.
+// The word must add at least one letter of its own.
+bool PlacementEngine::fits(const std::string& word, const Slot& slot) const {
+    const auto& [dr, dc] = kDirections[slot.dir];
+    const char* cell = (*grid)[slot.r] + slot.c;
+    ptrdiff_t step = static_cast<ptrdiff_t>(dr) * grid->stride() + dc;
+    bool addsLetter = false;
+    for (char letter : word) {
+        if (*cell == ' ') {
+            addsLetter = true;
+        }
+        else if (*cell != letter) {
+            return false;
+        }
+        cell += step;
+    }
+    return addsLetter;
+}
+
+void PlacementEngine::openSlots(const std::string& word, SlotCursor& cursor) {
+    if (overlap) {
+        rankSlots(word, cursor);
+        return;
+    }
+    int len = static_cast<int>(word.length());
+    cursor.total = 0;
+    for (int d = 0; d < kDirectionCount; ++d) {
+        cursor.total += table->range(len, d).count();
+    }
+    cursor.remaining = cursor.total;
+    cursor.position = cursor.total > 0 ? rng->below(cursor.total) : 0;
+    cursor.stride = 1;
+    if (cursor.total > 2) {
+        do {
+            cursor.stride = 1 + rng->below(cursor.total - 1);
+        } while (std::gcd(cursor.stride, cursor.total) != 1);
+    }
+}
+
+// Scores every in-bounds slot and groups the fitting ones by score. A slot's
+// key is (shared, touching), or shared alone without a penalty, so grouping
+// is counting rather than sorting. The first pass stores one key per slot;
+// the second emits a random sample of at most kMaxSlotsPerScore slots per
+// key, so only the slots kept are ever materialised.
+void PlacementEngine::rankSlots(const std::string& word, SlotCursor& cursor) {
+    const uint16_t kBlocked = 0xFFFF;
+    int len = static_cast<int>(word.length());
+    int width = grid->width();
+    int height = grid->height();
+    int stride = grid->stride();
+    bool penalised = adjacencyPenalty != 0.0f;
+
+    if (penalised) {
+        // Blank cells with a letter above, below, left or right
+        touching.assign(static_cast<size_t>(stride) * height, 0);
+        for (int r = 0; r < height; ++r) {
+            const char* row = (*grid)[r];
+            char* near = touching.data() + static_cast<size_t>(r) * stride;
+            for (int c = 0; c < width; ++c) {
+                if (row[c] == ' ' && ((c > 0 && row[c - 1] != ' ') || (c + 1 < width && row[c + 1] != ' ') ||
+                    (r > 0 && row[c - stride] != ' ') || (r + 1 < height && row[c + stride] != ' '))) {
+                    near[c] = static_cast<char>(0xFF);
+                }
+            }
+        }
+    }
+
+    int maxCount = std::min(len, 255);
+    int touchKeys = penalised ? maxCount + 1 : 1;
+    keyCounts.assign(static_cast<size_t>(maxCount + 1) * touchKeys, 0);
+    slotKeys.clear();
+    for (int d = 0; d < kDirectionCount; ++d) {
+        const SlotTable::Range& range = table->range(len, d);
+        if (range.empty()) {
+            continue;
+        }
+        checked += range.count();
+        const auto& [dr, dc] = kDirections[d];
+        ptrdiff_t step = static_cast<ptrdiff_t>(dr) * stride + dc;
+        int count = range.colEnd - range.colBegin;
+        runBlocked.resize(count);
+        runShared.resize(count);
+        runTouching.resize(count);
+        for (int r = range.rowBegin; r < range.rowEnd; ++r) {
+            size_t offset = static_cast<size_t>(r) * stride + range.colBegin;
+            scoreRun(grid->data() + offset, penalised ? touching.data() + offset : nullptr, step, word, count,
+                runBlocked.data(), runShared.data(), runTouching.data());
+            for (int i = 0; i < count; ++i) {
+                // Runs of open slots with nothing shared or touching are the
+                // common case on a sparse board; take them eight at a time
+                uint64_t any[3];
+                if (i + 8 <= count) {
+                    std::memcpy(&any[0], runBlocked.data() + i, 8);
+                    std::memcpy(&any[1], runShared.data() + i, 8);
+                    std::memcpy(&any[2], runTouching.data() + i, 8);
+                    if ((any[0] | any[1] | any[2]) == 0) {
+                        keyCounts[0] += 8;
+                        slotKeys.resize(slotKeys.size() + 8, 0);
+                        i += 7;
+                        continue;
+                    }
+                }
+                // A slot whose letters are all placed already would only
+                // restate part of another word, so it does not count as fitting
+                uint16_t key = kBlocked;
+                if (!runBlocked[i] && runShared[i] < len) {
+                    key = static_cast<uint16_t>(runShared[i] * touchKeys + runTouching[i]);
+                    keyCounts[key]++;
+                }
+                slotKeys.push_back(key);
+            }
+        }
+    }
+
+    // Keys by score, best first; more shared letters wins a tie
+    auto scoreOf = [&](int key) {
+        return static_cast<float>(key / touchKeys) - adjacencyPenalty * static_cast<float>(key % touchKeys);
+    };
+    keyOrder.clear();
+    for (size_t key = 0; key < keyCounts.size(); ++key) {
+        if (keyCounts[key] > 0) {
+            keyOrder.push_back(static_cast<int>(key));
+        }
+    }
+    std::sort(keyOrder.begin(), keyOrder.end(), [&](int a, int b) {
+        float scoreA = scoreOf(a);
+        float scoreB = scoreOf(b);
+        return scoreA != scoreB ? scoreA > scoreB : a > b;
+    });
+
+    // Pick which ranks (in scan order) of each key to keep, and where its
+    // slots go; keys with equal scores share a group
+    cursor.groups.clear();
+    keyPicks.clear();
+    keyState.assign(keyCounts.size(), KeySample());
+    size_t position = 0;
+    for (int key : keyOrder) {
+        size_t count = keyCounts[key];
+        size_t kept = std::min(count, kMaxSlotsPerScore);
+        KeySample& sample = keyState[key];
+        sample.output = position;
+        sample.nextPick = keyPicks.size();
+        if (kept < count) {
+            // Floyd's algorithm: kept distinct ranks out of count
+            size_t first = keyPicks.size();
+            for (size_t j = count - kept; j < count; ++j) {
+                size_t rank = rng->below(j + 1);
+                bool taken = std::find(keyPicks.begin() + first, keyPicks.end(), rank) != keyPicks.end();
+                keyPicks.push_back(taken ? j : rank);
+            }
+            std::sort(keyPicks.begin() + first, keyPicks.end());
+            sample.sampled = true;
+        }
+        float score = scoreOf(key);
+        if (cursor.groups.empty() || cursor.groups.back().score != score) {
+            cursor.groups.push_back({ position, position, score });
+        }
+        cursor.groups.back().end += kept;
+        position += kept;
+    }
+    for (int key : keyOrder) {
+        keyState[key].pickEnd = keyState[key].sampled ? keyState[key].nextPick + kMaxSlotsPerScore : 0;
+    }
+
+    cursor.ranked.resize(position);
+    size_t index = 0;
+    for (int d = 0; d < kDirectionCount; ++d) {
+        const SlotTable::Range& range = table->range(len, d);
+        if (range.empty()) {
+            continue;
+        }
+        for (int r = range.rowBegin; r < range.rowEnd; ++r) {
+            for (int c = range.colBegin; c < range.colEnd; ++c) {
+                uint16_t key = slotKeys[index++];
+                if (key == kBlocked) {
+                    continue;
+                }
+                KeySample& sample = keyState[key];
+                size_t rank = sample.seen++;
+                if (sample.sampled) {
+                    if (sample.nextPick == sample.pickEnd || keyPicks[sample.nextPick] != rank) {
+                        continue;
+                    }
+                    sample.nextPick++;
+                }
+                cursor.ranked[sample.output++] = { r, c, d };
+            }
+        }
+    }
+}
+
+// Draws a slot from a group chosen by softmax over the group scores (or the
+// best group at temperature 0), then uniformly within the group
+bool PlacementEngine::nextRankedSlot(SlotCursor& cursor, Slot& slot) {
+    if (cursor.groups.empty()) {
+        return false;
+    }
+    size_t g = 0;
+    if (temperature > 0.0f && cursor.groups.size() > 1) {
+        float best = cursor.groups.front().score;
+        double total = 0.0;
+        for (const ScoreGroup& group : cursor.groups) {
+            total += (group.end - group.begin) * std::exp((group.score - best) / temperature);
+        }
+        double target = static_cast<double>((*rng)() >> 11) / 9007199254740992.0 * total;  // [0, total)
+        for (g = 0; g + 1 < cursor.groups.size(); ++g) {
+            const ScoreGroup& group = cursor.groups[g];
+            target -= (group.end - group.begin) * std::exp((group.score - best) / temperature);
+            if (target < 0.0) {
+                break;
+            }
+        }
+    }
+
+    ScoreGroup& group = cursor.groups[g];
+    size_t pick = group.begin + rng->below(group.end - group.begin);
+    slot = cursor.ranked[pick];
+    cursor.ranked[pick] = cursor.ranked[--group.end];
+    if (group.end == group.begin) {
+        cursor.groups.erase(cursor.groups.begin() + g);
+    }
+    return true;
+}
+
+// Draws slots until one fits; retries only ever come from letter conflicts
+bool PlacementEngine::nextSlot(const std::string& word, SlotCursor& cursor, Slot& slot) {
+    if (overlap) {
+        return nextRankedSlot(cursor, slot);
+    }
+    int len = static_cast<int>(word.length());
+    while (cursor.remaining > 0) {
+        size_t index = cursor.position;
+        cursor.position = (cursor.position + cursor.stride) % cursor.total;
+        cursor.remaining--;
+
+        for (int d = 0; d < kDirectionCount; ++d) {
+            const SlotTable::Range& range = table->range(len, d);
+            size_t count = range.count();
+            if (index < count) {
+                size_t cols = static_cast<size_t>(range.colEnd - range.colBegin);
+                slot.r = range.rowBegin + static_cast<int>(index / cols);
+                slot.c = range.colBegin + static_cast<int>(index % cols);
+                slot.dir = d;
+                break;
+            }
+            index -= count;
+        }
+        checked++;
+        if (fits(word, slot)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PlacementEngine::write(const std::string& word, const Slot& slot) {
+    const auto& [dr, dc] = kDirections[slot.dir];
+    for (int i = 0; i < static_cast<int>(word.length()); ++i) {
+        int r = slot.r + i * dr;
+        int c = slot.c + i * dc;
+        if ((*grid)(r, c) == ' ') {
+            (*grid)(r, c) = word[i];
+            written.push_back(static_cast<size_t>(r) * grid->stride() + c);
+        }
+    }
+}
+
+void PlacementEngine::undo(size_t mark) {
+    while (written.size() > mark) {
+        grid->data()[written.back()] = ' ';
+        written.pop_back();
+    }
+}
+
+bool PlacementEngine::search(size_t depth) {
+    if (depth > bestDepth) {
+        bestDepth = depth;
+        bestGrid = *grid;
+    }
+    if (depth == order.size()) {
+        return true;
+    }
+
+    const std::string& word = (*words)[order[depth]];
+    SlotCursor& cursor = cursors[depth];
+    openSlots(word, cursor);
+    Slot slot;
+    while (nextSlot(word, cursor, slot)) {
+        if (++nodes > nodeBudget) {
+            outOfBudget = true;
+        }
+        if (outOfBudget) {
+            return false;
+        }
+
+        size_t mark = written.size();
+        write(word, slot);
+        if (search(depth + 1)) {
+            return true;
+        }
+        undo(mark);
+    }
+    return false;
+}
+
+std::vector<bool> PlacementEngine::placeAll(Grid& target, const std::vector<std::string>& wordList,
+    Rng& random) {
+    grid = &target;
+    table = &SlotTable::forSize(target.width(), target.height());
+    rng = &random;
+    words = &wordList;
+    outOfBudget = false;
+    nodes = 0;
+    checked = 0;
+    written.clear();
+    bestDepth = 0;
+    bestGrid = target;
+
+    // Words that cannot fit in any direction are left out of the search so
+    // they do not make every branch fail
+    int longestFit = std::max(target.width(), target.height());
+    order.clear();
+    for (size_t i = 0; i < wordList.size(); ++i) {
+        if (!wordList[i].empty() && static_cast<int>(wordList[i].length()) <= longestFit) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return wordList[a].length() > wordList[b].length();
+    });
+    cursors.resize(order.size());
+
+    std::vector<bool> placed(wordList.size(), false);
+    if (search(0)) {
+        for (int index : order) {
+            placed[index] = true;
+        }
+        return placed;
+    }
+
+    // Keep the deepest partial placement, then fit in whatever else still fits
+    target = bestGrid;
+    for (size_t depth = 0; depth < order.size(); ++depth) {
+        if (depth < bestDepth) {
+            placed[order[depth]] = true;
+            continue;
+        }
+        const std::string& word = wordList[order[depth]];
+        Slot slot;
+        openSlots(word, cursors[depth]);
+        if (nextSlot(word, cursors[depth], slot)) {
+            write(word, slot);
+            placed[order[depth]] = true;
+        }
+    }
+    return placed;
+}
+
+bool PlacementEngine::placeOne(Grid& target, const std::string& word, Rng& random) {
+    grid = &target;
+    table = &SlotTable::forSize(target.width(), target.height());
+    rng = &random;
+    written.clear();
+    checked = 0;
+    if (word.empty()) {
+        return false;
+    }
+
+    SlotCursor cursor;
+    Slot slot;
+    openSlots(word, cursor);
+    if (!nextSlot(word, cursor, slot)) {
+        return false;
+    }
+    write(word, slot);
+    return true;
+}
@@ -0,0 +1,109 @@
+#include "PuzzlePool.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+
+struct PuzzlePool::State {
+    std::mutex mutex;
+    std::condition_variable needed;
+    std::map<int, std::deque<WordSearchSolver>> puzzles;
+    size_t perSize = 0;
+    bool stopping = false;
+    StopSource stop;  // Aborts puzzles being generated when the pool goes away
+    Stats stats;
+};
+
+PuzzlePool::PuzzlePool(const std::vector<int>& sizes, size_t perSize)
+    : state(std::make_unique<State>()) {
+    state->perSize = perSize;
+    for (int size : sizes) {
+        state->puzzles[size];
+    }
+    for (int size : sizes) {
+        threads.emplace_back(refill, state.get(), size);
+    }
+}
+
+PuzzlePool::~PuzzlePool() {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping = true;
+    }
+    state->needed.notify_all();
+    state->stop.requestStop();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void PuzzlePool::refill(State* state, int size) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->needed.wait(lock, [&] {
+                return state->stopping || state->puzzles[size].size() < state->perSize;
+            });
+            if (state->stopping) {
+                return;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        WordSearchSolver solver;
+        solver.setFetchFailureLimit(kFetchFailuresBeforePause);
+        if (!solver.loadGrid(size, state->stop.token())) {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->stopping) {
+                return;
+            }
+            // The word API is unreachable or failing; try again later rather
+            // than keep the thread and a fresh TLS client busy
+            state->stats.failedRefills++;
+            state->stats.pausedSizes++;
+            state->needed.wait_for(lock, std::chrono::seconds(kPauseSeconds), [&] { return state->stopping; });
+            state->stats.pausedSizes--;
+            continue;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->stopping) {
+            return;
+        }
+        state->puzzles[size].push_back(std::move(solver));
+        Stats& stats = state->stats;
+        stats.refills++;
+        stats.meanRefillSeconds += (seconds - stats.meanRefillSeconds) / stats.refills;
+        stats.maxRefillSeconds = std::max(stats.maxRefillSeconds, seconds);
+    }
+}
+
+bool PuzzlePool::tryTake(int size, WordSearchSolver& solver) {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto it = state->puzzles.find(size);
+        if (it == state->puzzles.end() || it->second.empty()) {
+            state->stats.misses++;
+            return false;
+        }
+        solver = std::move(it->second.front());
+        it->second.pop_front();
+        state->stats.hits++;
+    }
+    state->needed.notify_all();
+    return true;
+}
+
+size_t PuzzlePool::ready(int size) const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto it = state->puzzles.find(size);
+    return it == state->puzzles.end() ? 0 : it->second.size();
+}
+
+PuzzlePool::Stats PuzzlePool::stats() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->stats;
+}
@@ -0,0 +1,58 @@
+#ifndef PUZZLE_POOL_H
+#define PUZZLE_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "WordSearchSolver.h"
+
+// Keeps a few finished puzzles per grid size generated in the background, so
+// starting a game takes a ready puzzle instead of waiting on loadGrid. Each
+// size has its own refill thread that tops its queue back up after a take.
+// Destroying the pool aborts puzzles in progress and waits for the threads,
+// at most one dictionary puzzle or one aborted word request. Without a local
+// dictionary, a size whose refill cannot get words from the API pauses for a
+// while instead of retrying.
+class PuzzlePool {
+public:
+    static constexpr size_t kDefaultPerSize = 2;
+    // Failed word requests in a row that end a refill, and how long its size
+    // then pauses before trying again
+    static constexpr int kFetchFailuresBeforePause = 5;
+    static constexpr int kPauseSeconds = 60;
+
+    struct Stats {
+        size_t hits = 0;          // Takes served from a ready puzzle
+        size_t misses = 0;        // Takes that found the queue empty
+        size_t refills = 0;       // Puzzles generated so far
+        double meanRefillSeconds = 0;
+        double maxRefillSeconds = 0;
+        size_t failedRefills = 0; // Refills that gave up on the word API
+        size_t pausedSizes = 0;   // Sizes currently paused after a failed refill
+    };
+
+    explicit PuzzlePool(const std::vector<int>& sizes, size_t perSize = kDefaultPerSize);
+    ~PuzzlePool();
+
+    PuzzlePool(const PuzzlePool&) = delete;
+    PuzzlePool& operator=(const PuzzlePool&) = delete;
+
+    // Moves a ready puzzle of this size into solver and returns true, or
+    // returns false (a miss) if none is ready yet
+    bool tryTake(int size, WordSearchSolver& solver);
+
+    // Puzzles of this size ready to take
+    size_t ready(int size) const;
+    Stats stats() const;
+
+private:
+    // Shared with the refill threads, which the destructor stops and joins
+    struct State;
+    static void refill(State* state, int size);
+
+    std::unique_ptr<State> state;
+    std::vector<std::thread> threads;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// xoshiro256** generator used for everything random in puzzle generation.
+// It is seeded from a single 64-bit value, so a puzzle regenerates exactly
+// from its seed, and jump() advances it by 2^128 steps, so split() hands out
+// non-overlapping streams to worker threads. Bounded integers and shuffles
+// are implemented here rather than with <random> distributions, whose
+// output differs between standard libraries.
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    explicit Rng(uint64_t seed = 0) {
+        // SplitMix64 spreads the seed over the whole state, which must not be all zero
+        for (uint64_t& word : state) {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    // A fresh seed from the OS, for callers that do not need reproducibility
+    static uint64_t randomSeed() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound), by Lemire's multiply-and-reject; bound must be > 0
+    uint64_t below(uint64_t bound) {
+        uint64_t low;
+        uint64_t high = multiply((*this)(), bound, low);
+        if (low < bound) {
+            uint64_t threshold = (0 - bound) % bound;
+            while (low < threshold) {
+                high = multiply((*this)(), bound, low);
+            }
+        }
+        return high;
+    }
+
+    // Uniform in [low, high]
+    int between(int low, int high) {
+        return low + static_cast<int>(below(static_cast<uint64_t>(high - low) + 1));
+    }
+
+    // Fisher-Yates shuffle of a random-access range
+    template <typename It>
+    void shuffle(It first, It last) {
+        auto count = std::distance(first, last);
+        for (auto i = count - 1; i > 0; --i) {
+            std::swap(first[i], first[static_cast<decltype(i)>(below(static_cast<uint64_t>(i) + 1))]);
+        }
+    }
+
+    // Advances the state by 2^128 steps
+    void jump() {
+        static const uint64_t kJump[] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+        };
+        uint64_t jumped[4] = { 0, 0, 0, 0 };
+        for (uint64_t bits : kJump) {
+            for (int b = 0; b < 64; ++b) {
+                if (bits & (1ull << b)) {
+                    for (int k = 0; k < 4; ++k) {
+                        jumped[k] ^= state[k];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int k = 0; k < 4; ++k) {
+            state[k] = jumped[k];
+        }
+    }
+
+    // Returns this generator's current stream and moves this one 2^128 steps
+    // ahead, so the two never overlap
+    Rng split() {
+        Rng stream = *this;
+        jump();
+        return stream;
+    }
+
+private:
+    // Full 128-bit product: returns the high half, stores the low half
+    static uint64_t multiply(uint64_t a, uint64_t b, uint64_t& low) {
+#ifdef _MSC_VER
+        low = a * b;
+        return __umulh(a, b);
+#else
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        low = static_cast<uint64_t>(product);
+        return static_cast<uint64_t>(product >> 64);
+#endif
+    }
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state[4];
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "SlotTable.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "GridSearch.h"
+
+namespace {
+
+const SlotTable::Range kNoSlots{ 0, 0, 0, 0 };
+
+}
+
+SlotTable::SlotTable(int width, int height)
+    : longest(std::max(width, height)) {
+    ranges.reserve(static_cast<size_t>(longest) * kDirectionCount);
+    for (int length = 1; length <= longest; ++length) {
+        int span = length - 1;
+        for (const auto& [dr, dc] : kDirections) {
+            // A walk that steps backwards must start far enough from the top/left edge
+            ranges.push_back({
+                dr < 0 ? span : 0, dr > 0 ? height - span : height,
+                dc < 0 ? span : 0, dc > 0 ? width - span : width
+            });
+        }
+    }
+}
+
+const SlotTable& SlotTable::forSize(int width, int height) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, std::unique_ptr<SlotTable>> tables;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<SlotTable>& table = tables[{ width, height }];
+    if (!table) {
+        table.reset(new SlotTable(width, height));
+    }
+    return *table;
+}
+
+const SlotTable::Range& SlotTable::range(int length, int dir) const {
+    if (length < 1 || length > longest) {
+        return kNoSlots;
+    }
+    return ranges[static_cast<size_t>(length - 1) * kDirectionCount + dir];
+}
@@ -0,0 +1,42 @@
+#ifndef SLOT_TABLE_H
+#define SLOT_TABLE_H
+
+#include <cstddef>
+#include <vector>
+
+// Start cells from which a word of a given length and direction stays on a
+// board of a given size. For each (length, direction) pair they form a
+// rectangle, so the table is a handful of integers per length and placement
+// enumerates legal slots directly instead of testing every cell against the
+// edges. Tables are built once per board size and shared.
+class SlotTable {
+public:
+    struct Range {
+        int rowBegin;
+        int rowEnd;
+        int colBegin;
+        int colEnd;
+
+        bool empty() const { return rowBegin >= rowEnd || colBegin >= colEnd; }
+        size_t count() const {
+            return empty() ? 0 : static_cast<size_t>(rowEnd - rowBegin) * (colEnd - colBegin);
+        }
+    };
+
+    // Shared table for a board size; thread-safe, and the reference stays valid
+    static const SlotTable& forSize(int width, int height);
+
+    // In-bounds start cells for a word of this length in direction dir
+    // (an index into kDirections); empty if the word cannot fit that way
+    const Range& range(int length, int dir) const;
+
+    int maxLength() const { return longest; }
+
+private:
+    SlotTable(int width, int height);
+
+    int longest;
+    std::vector<Range> ranges;  // kDirectionCount entries per length, from 1
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef STOP_TOKEN_H
+#define STOP_TOKEN_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Cooperative cancellation in the shape of C++20's std::stop_source,
+// std::stop_token and std::stop_callback, which this C++17 code cannot use.
+// Long-running work polls stopRequested() between steps; blocking calls
+// register a StopCallback that interrupts them (e.g. stops an HTTP client).
+
+namespace detail {
+
+struct StopState {
+    std::atomic<bool> stopped{ false };
+    std::mutex mutex;  // Held while callbacks run, so deregistering waits for them
+    std::map<uint64_t, std::function<void()>> callbacks;
+    uint64_t nextId = 0;
+};
+
+}
+
+class StopToken {
+public:
+    // A token that is never stopped
+    StopToken() = default;
+
+    bool stopRequested() const {
+        return state && state->stopped.load(std::memory_order_acquire);
+    }
+
+private:
+    friend class StopSource;
+    friend class StopCallback;
+    explicit StopToken(std::shared_ptr<detail::StopState> state) : state(std::move(state)) {}
+
+    std::shared_ptr<detail::StopState> state;
+};
+
+class StopSource {
+public:
+    StopSource() : state(std::make_shared<detail::StopState>()) {}
+
+    StopToken token() const { return StopToken(state); }
+    bool stopRequested() const { return state->stopped.load(std::memory_order_acquire); }
+
+    // Marks every token stopped and runs the registered callbacks once.
+    // Returns false if a stop had already been requested.
+    bool requestStop() {
+        if (state->stopped.exchange(true, std::memory_order_acq_rel)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for (auto& [id, callback] : state->callbacks) {
+            callback();
+        }
+        state->callbacks.clear();
+        return true;
+    }
+
+private:
+    std::shared_ptr<detail::StopState> state;
+};
+
+// Runs a callback when the token is stopped, or immediately if it already
+// is. Destroying the callback deregisters it, waiting if it is running.
+class StopCallback {
+public:
+    StopCallback(const StopToken& token, std::function<void()> callback) : state(token.state) {
+        if (!state) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->stopped.load(std::memory_order_acquire)) {
+                id = state->nextId++;
+                state->callbacks.emplace(id, std::move(callback));
+                registered = true;
+                return;
+            }
+        }
+        callback();
+    }
+
+    ~StopCallback() {
+        if (registered) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->callbacks.erase(id);
+        }
+    }
+
+    StopCallback(const StopCallback&) = delete;
+    StopCallback& operator=(const StopCallback&) = delete;
+
+private:
+    std::shared_ptr<detail::StopState> state;
+    uint64_t id = 0;
+    bool registered = false;
+};
+
+#endif
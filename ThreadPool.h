@@ -0,0 +1,57 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker takes
+// from the back of its own deque and, when that is empty, steals from the
+// front of the others, so uneven tasks (bands with many hits, puzzles of
+// different sizes) still keep every core busy.
+class ThreadPool {
+public:
+    // threadCount 0 means one worker per hardware thread
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool sized to the hardware
+    static ThreadPool& shared();
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    // Queues a task on the next worker in turn
+    void submit(std::function<void()> task);
+
+    // Runs task(i) for every i in [0, count) and returns once all have
+    // finished. The calling thread runs queued tasks while it waits.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popLocal(unsigned index, std::function<void()>& task);
+    bool steal(unsigned thief, std::function<void()>& task);
+    void workerLoop(unsigned index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<unsigned> nextQueue{ 0 };
+    std::atomic<size_t> queued{ 0 };
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+#endif
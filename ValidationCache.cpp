@@ -0,0 +1,192 @@
+#include "ValidationCache.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int64_t nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool expired(bool valid, int64_t timestamp, int64_t now) {
+    return !valid && now - timestamp > ValidationCache::kNegativeMaxAgeSeconds;
+}
+
+}
+
+ValidationCache::ValidationCache(size_t capacity)
+    : capacity(capacity) {
+}
+
+ValidationCache::~ValidationCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    batchReady.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    flush();
+}
+
+ValidationCache& ValidationCache::shared() {
+    static ValidationCache cache;
+    return cache;
+}
+
+bool ValidationCache::load(const std::string& file) {
+    int64_t now = nowSeconds();
+    size_t lines = 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    {
+        std::ifstream in(file);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string word;
+            int valid = 0;
+            int64_t timestamp = 0;
+            if (!(fields >> word >> valid >> timestamp)) {
+                continue;  // Torn write from a crash; skip it
+            }
+            lines++;
+            // Later lines supersede earlier ones for the same word
+            if (expired(valid != 0, timestamp, now)) {
+                auto it = index.find(word);
+                if (it != index.end()) {
+                    recent.erase(it->second);
+                    index.erase(it);
+                }
+                continue;
+            }
+            insert(word, valid != 0, timestamp);
+        }
+    }
+
+    fs::path parent = fs::path(file).parent_path();
+    std::error_code error;
+    if (!parent.empty()) {
+        fs::create_directories(parent, error);
+    }
+
+    // Rewrite the log once it is mostly superseded or expired lines, least
+    // recently used first so a replay rebuilds the same order
+    bool opened;
+    {
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        path = file;
+        if (lines > 2 * index.size() + kFlushBatch) {
+            std::ofstream out(file, std::ios::trunc);
+            for (auto it = recent.rbegin(); it != recent.rend(); ++it) {
+                out << it->word << '\t' << (it->valid ? 1 : 0) << '\t' << it->timestamp << '\n';
+            }
+            opened = static_cast<bool>(out);
+        }
+        else {
+            opened = static_cast<bool>(std::ofstream(file, std::ios::app));
+        }
+    }
+    if (!writing) {
+        writing = true;
+        writer = std::thread(&ValidationCache::writeBatches, this);
+    }
+    return opened;
+}
+
+void ValidationCache::insert(const std::string& word, bool valid, int64_t timestamp) {
+    auto it = index.find(word);
+    if (it != index.end()) {
+        it->second->valid = valid;
+        it->second->timestamp = timestamp;
+        recent.splice(recent.begin(), recent, it->second);
+        return;
+    }
+
+    recent.push_front(Entry{ word, valid, timestamp });
+    index.emplace(word, recent.begin());
+    if (recent.size() > capacity) {
+        index.erase(recent.back().word);
+        recent.pop_back();
+    }
+}
+
+std::optional<bool> ValidationCache::lookup(const std::string& word) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(word);
+    if (it == index.end()) {
+        return std::nullopt;
+    }
+    if (expired(it->second->valid, it->second->timestamp, nowSeconds())) {
+        recent.erase(it->second);
+        index.erase(it);
+        return std::nullopt;
+    }
+    recent.splice(recent.begin(), recent, it->second);
+    return it->second->valid;
+}
+
+void ValidationCache::store(const std::string& word, bool valid) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int64_t now = nowSeconds();
+        insert(word, valid, now);
+        if (!writing) {
+            return;  // Not loaded: memory only
+        }
+        pending.push_back(Entry{ word, valid, now });
+        if (pending.size() < kFlushBatch) {
+            return;
+        }
+    }
+    batchReady.notify_one();
+}
+
+void ValidationCache::flush() {
+    std::vector<Entry> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.swap(pending);
+    }
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    append(batch);
+}
+
+void ValidationCache::writeBatches() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        batchReady.wait(lock, [this] { return stopping || pending.size() >= kFlushBatch; });
+        if (stopping) {
+            return;  // The destructor flushes what is left
+        }
+        std::vector<Entry> batch;
+        batch.swap(pending);
+        lock.unlock();
+        {
+            // Lookups and stores carry on while this batch is written
+            std::lock_guard<std::mutex> fileLock(fileMutex);
+            append(batch);
+        }
+        lock.lock();
+    }
+}
+
+void ValidationCache::append(const std::vector<Entry>& entries) {
+    if (path.empty() || entries.empty()) {
+        return;  // Not loaded: memory only
+    }
+    std::ofstream out(path, std::ios::app);
+    for (const Entry& entry : entries) {
+        out << entry.word << '\t' << (entry.valid ? 1 : 0) << '\t' << entry.timestamp << '\n';
+    }
+}
+
+size_t ValidationCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return index.size();
+}
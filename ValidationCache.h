@@ -0,0 +1,80 @@
+#ifndef VALIDATION_CACHE_H
+#define VALIDATION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Remembers Dictionary API verdicts across sessions. Both valid and invalid
+// words are cached, in memory as an LRU map and on disk as an append-only
+// log of "WORD<TAB>0|1<TAB>unix-seconds" lines that is replayed at startup.
+// New verdicts are appended in batches by a writer thread started by load(),
+// so validation threads never wait on the disk.
+class ValidationCache {
+public:
+    // Default location, relative to the working directory like output/
+    static constexpr const char* kDefaultPath = "cache/validated_words.txt";
+    // Words kept in memory before the least recently used one is evicted
+    static constexpr size_t kDefaultCapacity = 100000;
+    // Verdicts written to the file at a time
+    static constexpr size_t kFlushBatch = 64;
+    // Invalid verdicts are re-checked after this long, in case the API learns the word
+    static constexpr int64_t kNegativeMaxAgeSeconds = 30 * 24 * 60 * 60;
+
+    explicit ValidationCache(size_t capacity = kDefaultCapacity);
+    ~ValidationCache();
+
+    ValidationCache(const ValidationCache&) = delete;
+    ValidationCache& operator=(const ValidationCache&) = delete;
+
+    // Process-wide cache used by word validation
+    static ValidationCache& shared();
+
+    // Replays the cache file, if any, and has the writer thread append new
+    // verdicts to it from now on. A log with many superseded lines is rewritten compactly. Returns
+    // false if the file cannot be opened for appending; the cache then
+    // works in memory only.
+    bool load(const std::string& path);
+
+    // Cached verdict for an upper-cased word, or nothing if it must be checked
+    std::optional<bool> lookup(const std::string& word);
+    void store(const std::string& word, bool valid);
+
+    // Writes out verdicts not yet in the file, on the calling thread
+    void flush();
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::string word;
+        bool valid;
+        int64_t timestamp;
+    };
+
+    void insert(const std::string& word, bool valid, int64_t timestamp);  // mutex held
+    void append(const std::vector<Entry>& entries);                       // fileMutex held
+    void writeBatches();
+
+    size_t capacity;
+    mutable std::mutex mutex;
+    std::list<Entry> recent;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::vector<Entry> pending;  // Only kept once load() has started the writer
+    bool writing = false;
+    bool stopping = false;
+    std::condition_variable batchReady;
+
+    std::mutex fileMutex;  // Serializes file writes; never held while taking mutex
+    std::string path;
+    std::thread writer;
+};
+
+#endif
@@ -1,6 +1,13 @@
 ﻿#define CPPHTTPLIB_OPENSSL_SUPPORT
 #define NOMINMAX
 #include "WordSearchSolver.h"
+#include "BlockingQueue.h"
+#include "Dictionary.h"
+#include "FillEngine.h"
+#include "HttpClientPool.h"
+#include "PlacementEngine.h"
+#include "StopToken.h"
+#include "ValidationCache.h"
 #include <iostream>
 #include <random>
 #include <thread>
@@ -10,7 +17,11 @@
 #include <mutex>
 #include <atomic>
 #include <algorithm>
-#include <future>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <optional>
 #include "json.hpp" 
 #include <filesystem>
 #include <fstream>
@@ -19,10 +30,17 @@ using json = nlohmann::json;
 
 // **Global Target Words List**
 std::vector<std::string> targetWords;
-std::mutex apiMutex;  // Mutex for API synchronization
+
+// Dictionary API requests allowed in flight at once while validating a batch
+static const int maxValidationRequests = 12;
+
+// Wait before retrying a failed word request, doubled for each failure in a
+// row up to the cap, so an unreachable API is not retried in a tight loop
+static const std::chrono::milliseconds fetchRetryDelay(250);
+static const std::chrono::milliseconds maxFetchRetryDelay(30000);
 
 WordSearchSolver::WordSearchSolver() {
-    grid.clear();
+    grid.reset(0, 0);
 }
 
 // **API Response Handling**
@@ -42,141 +60,305 @@ static std::string capitalizeWord(const std::string& word) {
     return capitalized;
 }
 
-// Validate a word using the Dictionary API via httplib
-static bool isValidEnglishWord(const std::string& word) {
-    std::lock_guard<std::mutex> lock(apiMutex);
+// GET that a stop request aborts: in flight by shutting the client's socket,
+// and while the body streams in through the progress callback
+static httplib::Result cancellableGet(HttpClientPool::Lease& cli, const std::string& path, const StopToken& stop) {
+    if (stop.stopRequested()) {
+        return httplib::Result(nullptr, httplib::Error::Canceled);
+    }
+    StopCallback abort(stop, [&cli] { cli->stop(); });
+    return cli->Get(path, [&stop](uint64_t, uint64_t) { return !stop.stopRequested(); });
+}
+
+// Sleeps for the given time, or until stop is requested; returns false if it was
+static bool sleepUnlessStopped(const StopToken& stop, std::chrono::milliseconds duration) {
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopped = false;
+    StopCallback callback(stop, [&] {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        wake.notify_all();
+    });
+    std::unique_lock<std::mutex> lock(mutex);
+    return !wake.wait_for(lock, duration, [&] { return stopped; });
+}
+
+// Validate a word against the local dictionary, or the Dictionary API via
+// httplib when no local word list was loaded. API verdicts are cached.
+static bool isValidEnglishWord(const std::string& word, const StopToken& stop) {
+    const Dictionary& dictionary = Dictionary::shared();
+    if (dictionary.loaded()) {
+        return dictionary.contains(word);
+    }
+    ValidationCache& cache = ValidationCache::shared();
+    if (std::optional<bool> cached = cache.lookup(word)) {
+        return *cached;
+    }
 
     std::string host = "api.dictionaryapi.dev";
     std::string path = "/api/v2/entries/en/" + word;
-    httplib::SSLClient cli(host.c_str());
-    cli.set_connection_timeout(3, 0);
-    cli.set_read_timeout(3, 0);
+    HttpClientPool::Lease cli = HttpClientPool::shared().acquire(host);
 
-    if (auto res = cli.Get(path.c_str())) {
-        if (res->status == 200 && res->body.find("\"title\":\"No Definitions Found\"") == std::string::npos) {
-            return true;
+    if (auto res = cancellableGet(cli, path, stop)) {
+        bool valid = res->status == 200 && res->body.find("\"title\":\"No Definitions Found\"") == std::string::npos;
+        // Server errors say nothing about the word, so only definite answers are kept
+        if (res->status == 200 || res->status == 404) {
+            cache.store(word, valid);
         }
+        return valid;
     }
+    cli.discard();  // Broken or aborted connection; the next request gets a fresh client
     return false;
 }
 
-static std::vector<std::string> fetchValidWords(int wordCount, int minLen, int maxLen) {
-    std::vector<std::string> validWords;
-    int batchSize = std::min(30, wordCount);
-    int wordsFetched = 0;
-
-    while (wordsFetched < wordCount) {
-        int wordLength = minLen + (rand() % (maxLen - minLen + 1));
-        std::string host = "random-word-api.herokuapp.com";
-        std::string path = "/word?length=" + std::to_string(wordLength) + "&number=" + std::to_string(batchSize);
-        httplib::SSLClient cli(host.c_str());
-        cli.set_connection_timeout(3, 0);
-        cli.set_read_timeout(3, 0);
-
-        auto res = cli.Get(path.c_str());
-        if (!res || res->status != 200) {
-            continue;
+// Random distinct words from the local dictionary; no network involved
+static std::vector<std::string> pickDictionaryWords(int wordCount, int minLen, int maxLen, Rng& rng) {
+    const Dictionary& dictionary = Dictionary::shared();
+
+    std::vector<std::string> words;
+    std::unordered_set<std::string> picked;
+    // Bounded so a dictionary without enough words of these lengths cannot hang us
+    int attempts = wordCount * 20;
+    while (static_cast<int>(words.size()) < wordCount && attempts-- > 0) {
+        std::string word = dictionary.randomWord(rng.between(minLen, maxLen), rng);
+        if (!word.empty() && picked.insert(word).second) {
+            words.push_back(word);
+        }
+    }
+    return words;
+}
+
+// Validates a whole batch with up to maxValidationRequests concurrent requests.
+// valid[i] belongs to words[i], so callers see the batch in its original order
+// however the requests finish. Words left when a stop is requested stay invalid.
+static std::vector<char> validateWords(const std::vector<std::string>& words, const StopToken& stop) {
+    std::vector<char> valid(words.size(), 0);
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t i = next++; i < words.size() && !stop.stopRequested(); i = next++) {
+            valid[i] = isValidEnglishWord(words[i], stop);
         }
+    };
+
+    int threadCount = std::min(maxValidationRequests, static_cast<int>(words.size()));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return valid;
+}
+
+// Stages of the online word pipeline. The fetcher keeps at most one raw batch
+// waiting while the validator works on the previous one, and the validator
+// hands each valid word downstream as soon as its batch is checked. Stopping
+// the pipeline aborts its requests and closes both queues. A fetcher that
+// gives up closes the fetched queue, which ends the pipeline once drained.
+struct WordPipeline {
+    BlockingQueue<std::vector<std::string>> fetched{ 1 };
+    BlockingQueue<std::string> validated;
+    StopSource stop;
+    std::atomic<bool> gaveUp{ false };
 
-        try {
-            // Parse the response into a JSON array.
-            auto j = json::parse(res->body);
-            // Expecting an array of words, e.g., ["word1", "word2", ...]
-            for (auto& element : j) {
-                std::string word = element.get<std::string>();
-                word = capitalizeWord(word);
-                auto futureValidation = std::async(std::launch::async, isValidEnglishWord, word);
-                if (futureValidation.get()) {
-                    validWords.push_back(word);
-                    wordsFetched++;
-                    if (wordsFetched >= wordCount) break;
+    void shutdown() {
+        stop.requestStop();
+        fetched.close();
+        validated.close();
+    }
+};
+
+// failureLimit failed requests in a row make the fetcher give up; 0 retries until stopped
+static void fetchBatches(std::shared_ptr<WordPipeline> pipeline, int batchSize, int minLen, int maxLen,
+    int failureLimit, Rng rng) {
+    std::string host = "random-word-api.herokuapp.com";
+    StopToken stop = pipeline->stop.token();
+    int failures = 0;
+    std::chrono::milliseconds retryDelay = fetchRetryDelay;
+
+    while (!stop.stopRequested()) {
+        std::string path = "/word?length=" + std::to_string(rng.between(minLen, maxLen)) + "&number=" + std::to_string(batchSize);
+        HttpClientPool::Lease cli = HttpClientPool::shared().acquire(host);
+        httplib::Result res = cancellableGet(cli, path, stop);
+
+        std::vector<std::string> batch;
+        if (!res) {
+            cli.discard();
+        }
+        else if (res->status == 200) {
+            try {
+                // Expecting an array of words, e.g., ["word1", "word2", ...]
+                auto j = json::parse(res->body);
+                for (auto& element : j) {
+                    batch.push_back(capitalizeWord(element.get<std::string>()));
                 }
             }
+            catch (json::exception& e) {
+                std::cerr << "JSON Parse Error: " << e.what() << std::endl;
+                batch.clear();
+            }
         }
-        catch (json::parse_error& e) {
-            std::cerr << "JSON Parse Error: " << e.what() << std::endl;
+
+        if (batch.empty()) {
+            if (stop.stopRequested()) {
+                return;  // Aborted, not failed
+            }
+            if (++failures == failureLimit) {
+                pipeline->gaveUp = true;
+                pipeline->fetched.close();
+                return;
+            }
+            if (!sleepUnlessStopped(stop, retryDelay)) {
+                return;
+            }
+            retryDelay = std::min(retryDelay * 2, maxFetchRetryDelay);
             continue;
         }
+        failures = 0;
+        retryDelay = fetchRetryDelay;
+        if (!pipeline->fetched.push(std::move(batch))) {
+            return;
+        }
     }
+}
 
-    return validWords;
+static void validateBatches(std::shared_ptr<WordPipeline> pipeline) {
+    std::vector<std::string> batch;
+    while (pipeline->fetched.pop(batch)) {
+        std::vector<char> valid = validateWords(batch, pipeline->stop.token());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (valid[i] && !pipeline->validated.push(batch[i])) {
+                return;
+            }
+        }
+    }
+    pipeline->validated.close();
 }
 
-bool WordSearchSolver::placeWordInGrid(const std::string& word) {
-    int size = grid.size();
-    const int maxAttempts = 100;  // You can adjust this as needed
-    int attempts = 0;
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::vector<std::pair<int, int>> directions = {
-        {0, 1}, {1, 0}, {0, -1}, {-1, 0}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
-    };
+// Feeds words from the online APIs to onWord, in arrival order, until it
+// returns false or stop is requested. Fetching, validation and the caller's
+// placement run as overlapping stages, so the first words are placed after
+// one round trip. rng picks the requested word lengths. Returns false if the
+// word API failed fetchFailureLimit times in a row (0: no limit) before onWord
+// was satisfied.
+static bool streamValidWords(int wordCount, int minLen, int maxLen, int fetchFailureLimit, Rng rng,
+    const StopToken& stop, const std::function<bool(const std::string&)>& onWord) {
+    auto pipeline = std::make_shared<WordPipeline>();
+    int batchSize = std::min(30, wordCount);
+    std::thread fetcher(fetchBatches, pipeline, batchSize, minLen, maxLen, fetchFailureLimit, rng);
+    std::thread validator(validateBatches, pipeline);
 
-    while (attempts < maxAttempts) {
-        // Randomize starting position and directions
-        int x = rand() % size;
-        int y = rand() % size;
-        std::shuffle(directions.begin(), directions.end(), gen);
-
-        for (const auto& [dx, dy] : directions) {
-            int nx = x, ny = y, i;
-            for (i = 0; i < word.length(); ++i) {
-                if (nx < 0 || ny < 0 || nx >= size || ny >= size ||
-                    (grid[nx][ny] != ' ' && grid[nx][ny] != word[i]))
-                {
-                    break;
-                }
-                nx += dx;
-                ny += dy;
-            }
-            if (i == word.length()) {  // Valid placement found
-                nx = x;
-                ny = y;
-                for (char c : word) {
-                    grid[nx][ny] = c;
-                    nx += dx;
-                    ny += dy;
-                }
-                return true;  // Indicate that the word was placed
-            }
+    {
+        // Wakes the pop below as well as aborting the stages
+        StopCallback cancel(stop, [&pipeline] { pipeline->shutdown(); });
+        std::string word;
+        while (pipeline->validated.pop(word) && onWord(word)) {
         }
-        attempts++;
     }
-    return false;  // Failed to place the word after maxAttempts
+
+    // Requests in flight are aborted, so the stages exit promptly; only a
+    // connection still being set up takes up to its 3 s timeout to notice.
+    // They are joined rather than detached because they use the shared HTTP
+    // client pool and validation cache, which must not be destroyed under them.
+    pipeline->shutdown();
+    fetcher.join();
+    validator.join();
+    return !pipeline->gaveUp;
+}
+
+bool WordSearchSolver::placeWordInGrid(const std::string& word, Rng& rng) {
+    PlacementEngine placement;
+    if (denseLayout) {
+        placement.preferOverlap();
+    }
+    return placement.placeOne(grid, word, rng);
 }
 
+bool WordSearchSolver::loadGrid(int size, const StopToken& stop) {
+    return loadGrid(size, Rng::randomSeed(), stop);
+}
 
-void WordSearchSolver::loadGrid(int size) {
-    grid.resize(size, std::vector<char>(size, ' '));
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis('A', 'Z');
+bool WordSearchSolver::loadGrid(int size, uint64_t seed, const StopToken& stop) {
+    return generateGrid(size, (size + size) / 2, seed, stop);  // (Rows + Columns) / 2 words
+}
 
-    int numWords = (size + size) / 2;  // (Rows + Columns) / 2
-    int minWordLength = std::max(3, size / 4);
-    int maxWordLength = size;
+bool WordSearchSolver::generateGrid(int size, int numWords, uint64_t seed, const StopToken& stop) {
+    puzzleSeed = seed;
+    grid.reset(size, size, ' ');
+    // One stream picks words, the other places them and fills the rest
+    Rng rng(seed);
+    Rng wordRng = rng.split();
 
-    // Fetch words asynchronously
-    std::future<std::vector<std::string>> futureWords =
-        std::async(std::launch::async, fetchValidWords, numWords, minWordLength, maxWordLength);
-    std::vector<std::string> fetchedWords = futureWords.get();
+    int minWordLength = shortestWord > 0 ? shortestWord : std::max(3, size / 4);
+    int maxWordLength = longestWord > 0 ? std::min(longestWord, size) : size;
+    if (Dictionary::shared().loaded()) {
+        // Big print grids would otherwise ask only for lengths the list does not have
+        maxWordLength = std::min(maxWordLength, Dictionary::shared().maxLength());
+    }
+    minWordLength = std::min(minWordLength, maxWordLength);
 
-    // Try to place each word; only keep the ones that are successfully placed
+    PlacementEngine placement;
+    if (denseLayout) {
+        placement.preferOverlap();
+    }
     targetWords.clear();
-    for (const std::string& word : fetchedWords) {
-        if (placeWordInGrid(word)) {
-            targetWords.push_back(word);
+    pickedWords = 0;
+    bool wordsAvailable = true;
+    if (Dictionary::shared().loaded()) {
+        // The whole set is known up front, so place it with backtracking
+        std::vector<std::string> words = pickDictionaryWords(numWords, minWordLength, maxWordLength, wordRng);
+        pickedWords = words.size();
+        std::vector<bool> placed = placement.placeAll(grid, words, rng);
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (placed[i]) {
+                targetWords.push_back(words[i]);
+            }
         }
     }
+    else {
+        // Place words as they arrive; the grid is ready once enough are placed.
+        // Words that no longer fit are skipped, within a bounded number of candidates.
+        std::unordered_set<std::string> seen;  // The same word twice could be placed on top of itself
+        int candidates = numWords * 10;
+        wordsAvailable = streamValidWords(numWords, minWordLength, maxWordLength, fetchFailureLimit, wordRng, stop,
+            [&](const std::string& word) {
+                pickedWords++;
+                if (seen.insert(word).second && placeWordInGrid(word, rng)) {
+                    targetWords.push_back(word);
+                }
+                return static_cast<int>(targetWords.size()) < numWords && --candidates > 0;
+            });
+    }
+    // Built before the early exits too, so an unfinished grid still has a
+    // trie that matches its target words
+    targetTrie.build(targetWords);
+    if (stop.stopRequested() || !wordsAvailable) {
+        bitboard.build(grid);
+        return false;
+    }
 
-    // Fill only the empty spaces with random letters
-    for (auto& row : grid) {
-        for (auto& cell : row) {
-            if (cell == ' ') {
-                cell = dis(gen);
-            }
+    // Fill only the empty spaces, with letters that spell no extra target
+    // word and nothing on the blocklist
+    FillEngine::shared().fill(grid, targetWords, rng);
+
+    // The fill spells no target word, but placed words can still spell one a
+    // second time between them. Such a word has two answers, so it is left in
+    // the grid as an ordinary word and dropped from the targets. Checked on
+    // the bitboard, so only for grids up to 64 columns (every UI mode).
+    if (bitboard.build(grid)) {
+        auto ambiguous = std::remove_if(targetWords.begin(), targetWords.end(), [this](const std::string& word) {
+            return bitboard.countOccurrences(word) > 1;
+        });
+        if (ambiguous != targetWords.end()) {
+            targetWords.erase(ambiguous, targetWords.end());
+            targetTrie.build(targetWords);
         }
     }
+    return true;
 }
 void WordSearchSolver::saveGridToFile(const std::string& filename) {
     // Create an output directory if it doesn't exist.
@@ -193,9 +375,10 @@ void WordSearchSolver::saveGridToFile(const std::string& filename) {
     }
 
     file << "Word Search Grid:\n";
-    for (const auto& row : grid) {
-        for (char c : row) {
-            file << c << " ";
+    for (int r = 0; r < grid.height(); ++r) {
+        const char* row = grid[r];
+        for (int c = 0; c < grid.width(); ++c) {
+            file << row[c] << " ";
         }
         file << "\n";
     }
@@ -204,6 +387,27 @@ void WordSearchSolver::saveGridToFile(const std::string& filename) {
     for (const std::string& word : targetWords) {
         file << word << "\n";
     }
+
+    // Regenerates this puzzle with loadGrid(size, seed)
+    file << "\nSeed: " << puzzleSeed << "\n";
+
+    // Answer key: first occurrence of each word
+    std::vector<WordHit> hits(targetWords.size() * 2);
+    size_t hitCount = solveTargets(hits.data(), hits.size());
+    if (hitCount > hits.size()) {
+        hits.resize(hitCount);
+        hitCount = solveTargets(hits.data(), hits.size());
+    }
+    std::vector<bool> written(targetWords.size(), false);
+    file << "\nAnswer key:\n";
+    for (size_t k = 0; k < hitCount; ++k) {
+        const WordHit& hit = hits[k];
+        if (!written[hit.wordIndex]) {
+            written[hit.wordIndex] = true;
+            file << targetWords[hit.wordIndex] << " at (" << hit.row << ", " << hit.col << ") "
+                << kDirectionNames[hit.dir] << "\n";
+        }
+    }
     file.close();
     std::cout << "Grid saved to " << fullPath << std::endl;
 }
@@ -213,9 +417,10 @@ void WordSearchSolver::saveGridToFile(const std::string& filename) {
 // **Display Grid and Words**
 void WordSearchSolver::displayGrid() {
     std::cout << "\nWord Search Grid:\n";
-    for (const auto& row : grid) {
-        for (char c : row) {
-            std::cout << c << " ";
+    for (int r = 0; r < grid.height(); ++r) {
+        const char* row = grid[r];
+        for (int c = 0; c < grid.width(); ++c) {
+            std::cout << row[c] << " ";
         }
         std::cout << std::endl;
     }
@@ -226,7 +431,87 @@ void WordSearchSolver::displayGrid() {
     }
 }
 
-// **Solve (Placeholder)**
+void WordSearchSolver::setGrid(const Grid& cells) {
+    grid = cells;
+    for (int r = 0; r < grid.height(); ++r) {
+        char* row = grid[r];
+        for (int c = 0; c < grid.width(); ++c) {
+            row[c] = std::toupper(static_cast<unsigned char>(row[c]));
+        }
+    }
+    targetWords.clear();
+    targetTrie.build(targetWords);
+    bitboard.build(grid);
+}
+
+// **Solve: scan the grid for the placed target words**
 std::vector<std::string> WordSearchSolver::solve() {
-    return targetWords;
-}
\ No newline at end of file
+    return solve(targetWords);
+}
+
+std::vector<std::string> WordSearchSolver::solve(const std::vector<std::string>& words,
+    SolveMethod method) const {
+    // Past a few dozen words the trie is dense near the root and every
+    // direction walks several levels, so one automaton pass per line wins
+    const size_t ahoCorasickMinWords = 64;
+    if (method == SolveMethod::Bitboard && grid.width() > LetterBitboard::kMaxWidth) {
+        method = SolveMethod::Auto;
+    }
+    if (method == SolveMethod::Auto) {
+        method = words.size() >= ahoCorasickMinWords ? SolveMethod::AhoCorasick : SolveMethod::Trie;
+    }
+
+    std::vector<bool> found;
+    std::vector<int> canonical(words.size(), -1);
+    if (method == SolveMethod::Bitboard) {
+        found.assign(words.size(), false);
+        for (size_t i = 0; i < words.size(); ++i) {
+            canonical[i] = static_cast<int>(i);
+            found[i] = bitboard.contains(capitalizeWord(words[i]));
+        }
+    }
+    else if (method == SolveMethod::AhoCorasick) {
+        AhoCorasick automaton(words);
+        findWordsWithAhoCorasick(grid, automaton, found);
+        for (size_t i = 0; i < words.size(); ++i) {
+            canonical[i] = automaton.canonicalIndex(static_cast<int>(i));
+        }
+    }
+    else {
+        WordTrie trie(words);
+        findWordsWithTrie(grid, trie, found);
+        for (size_t i = 0; i < words.size(); ++i) {
+            canonical[i] = trie.canonicalIndex(static_cast<int>(i));
+        }
+    }
+
+    std::vector<std::string> foundWords;
+    for (size_t i = 0; i < words.size(); ++i) {
+        int index = canonical[i];
+        if (index >= 0 && found[index]) {
+            foundWords.push_back(words[i]);
+        }
+    }
+    return foundWords;
+}
+
+size_t WordSearchSolver::solve(const WordTrie& words, WordHit* hits, size_t capacity) const {
+    return findHitsWithTrie(grid, words, hits, capacity);
+}
+
+size_t WordSearchSolver::solve(const AhoCorasick& words, WordHit* hits, size_t capacity) const {
+    return findHitsWithAhoCorasick(grid, words, hits, capacity);
+}
+
+size_t WordSearchSolver::solveTargets(WordHit* hits, size_t capacity) const {
+    return solve(targetTrie, hits, capacity);
+}
+
+bool WordSearchSolver::containsWord(const std::string& word) const {
+    if (grid.width() <= LetterBitboard::kMaxWidth) {
+        return bitboard.contains(capitalizeWord(word));
+    }
+    std::vector<bool> found;
+    findWordsWithTrie(grid, WordTrie({ word }), found);
+    return found[0];
+}
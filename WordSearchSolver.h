@@ -3,26 +3,102 @@
 
 #include <vector>
 #include <string>
+#include "AhoCorasick.h"
+#include "Grid.h"
+#include "LetterBitboard.h"
+#include "Rng.h"
+#include "StopToken.h"
+#include "GridSearch.h"
+#include "WordTrie.h"
+
+// Scan engine used by solve(); Auto picks Aho-Corasick for large word lists.
+// Bitboard needs a grid at most 64 columns wide and falls back to Auto otherwise.
+enum class SolveMethod {
+    Auto,
+    Trie,
+    AhoCorasick,
+    Bitboard
+};
 
 class WordSearchSolver {
 private:
-    std::vector<std::vector<char>> grid;
+    Grid grid;
     std::vector<std::string> targetWords; // Stores words to find
+    WordTrie targetTrie;                  // Trie of targetWords, rebuilt with the grid
+    LetterBitboard bitboard;              // Letter masks of the grid; finds target words spelled twice
+    uint64_t puzzleSeed = 0;              // Seed loadGrid generated the grid from
+    bool denseLayout = false;             // Place words to share letters where they can
+    int fetchFailureLimit = 0;            // Failed word requests in a row before giving up; 0: never
+    int shortestWord = 0;                 // Word length range from setWordLengths; 0: scaled to the grid
+    int longestWord = 0;
+    size_t pickedWords = 0;               // Words tried for the last grid, placed or not
 
     // Places a word into the grid at a random valid position
-    bool placeWordInGrid(const std::string& word);
+    bool placeWordInGrid(const std::string& word, Rng& rng);
 
 
 public:
     WordSearchSolver();
-    void loadGrid(int size);
+    // Generates a new puzzle. Returns false, leaving the grid unfinished, if
+    // stop was requested first (pending word requests are aborted) or the
+    // word API kept failing (see setFetchFailureLimit).
+    bool loadGrid(int size, const StopToken& stop = StopToken());
+    // Same, from a given seed. With a local dictionary the same seed always
+    // gives the same puzzle; online words depend on what the APIs return.
+    bool loadGrid(int size, uint64_t seed, const StopToken& stop = StopToken());
+    // Same with a chosen number of words instead of one per row. Words that
+    // do not fit are left out of the target list.
+    bool generateGrid(int size, int numWords, uint64_t seed, const StopToken& stop = StopToken());
+    // Packs words so they cross and share letters, for denser, harder
+    // puzzles; applies to grids generated afterwards
+    void setDenseLayout(bool dense) {
+        denseLayout = dense;
+    }
+    // Without a local dictionary, failed word requests are retried with a
+    // growing delay. With a limit, that many failures in a row make the
+    // generation give up instead; 0, the default, retries until stopped.
+    void setFetchFailureLimit(int limit) {
+        fetchFailureLimit = limit;
+    }
+    // Lengths of the words to pick; 0 keeps the default of a quarter of the
+    // grid's side (at least 3) up to all of it. Either way the range is
+    // capped at the grid's side and the local dictionary's longest word.
+    void setWordLengths(int minLength, int maxLength) {
+        shortestWord = minLength;
+        longestWord = maxLength;
+    }
     void displayGrid();
     std::vector<std::string> solve();
+    // Scans the current grid in all 8 directions and returns the given words
+    // that occur in it, in their original order
+    std::vector<std::string> solve(const std::vector<std::string>& words,
+        SolveMethod method = SolveMethod::Auto) const;
+    // Writes every occurrence of the prebuilt words into a caller-provided
+    // buffer (see findHitsWithTrie for the allocation contract); returns the
+    // total, which may exceed capacity
+    size_t solve(const WordTrie& words, WordHit* hits, size_t capacity) const;
+    size_t solve(const AhoCorasick& words, WordHit* hits, size_t capacity) const;
+    // Occurrences of the target words, indexed like targetWords
+    size_t solveTargets(WordHit* hits, size_t capacity) const;
+    // Whether a word occurs anywhere in the grid, in any direction
+    bool containsWord(const std::string& word) const;
+    // Replaces the grid with one that was not generated here (imported or user-submitted)
+    void setGrid(const Grid& cells);
     void saveGridToFile(const std::string& filename);
     
-    const std::vector<std::vector<char>>& getGrid() const {
+    const Grid& getGrid() const {
         return grid;
     }
+    uint64_t getSeed() const {
+        return puzzleSeed;
+    }
+    const std::vector<std::string>& getTargetWords() const {
+        return targetWords;
+    }
+    // Words picked for the last generated grid, including those that did not fit
+    size_t getPickedWordCount() const {
+        return pickedWords;
+    }
 };
 
 #endif
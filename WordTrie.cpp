@@ -0,0 +1,62 @@
+#include "WordTrie.h"
+#include <algorithm>
+#include <cctype>
+
+WordTrie::WordTrie() {
+    build({});
+}
+
+WordTrie::WordTrie(const std::vector<std::string>& words) {
+    build(words);
+}
+
+int WordTrie::addNode() {
+    Node node;
+    node.next.fill(kNoNode);
+    node.word = -1;
+    nodes.push_back(node);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+void WordTrie::build(const std::vector<std::string>& words) {
+    build(words.data(), words.size());
+}
+
+void WordTrie::build(const std::string* words, size_t count) {
+    nodes.clear();
+    canonical.assign(count, -1);
+    uniqueWords = 0;
+    maxLength = 0;
+    addNode();
+
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& word = words[i];
+        bool valid = !word.empty();
+        for (char c : word) {
+            if (!std::isalpha(static_cast<unsigned char>(c))) {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid) {
+            continue;
+        }
+
+        int node = root();
+        for (char c : word) {
+            int index = std::toupper(static_cast<unsigned char>(c)) - 'A';
+            if (nodes[node].next[index] == kNoNode) {
+                int created = addNode();  // May reallocate, so index again below
+                nodes[node].next[index] = created;
+            }
+            node = nodes[node].next[index];
+        }
+
+        if (nodes[node].word < 0) {
+            nodes[node].word = static_cast<int>(i);
+            uniqueWords++;
+        }
+        canonical[i] = nodes[node].word;
+        maxLength = std::max(maxLength, word.length());
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef WORD_TRIE_H
+#define WORD_TRIE_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Prefix trie over the words to find, stored as one flat node array so a grid
+// scan follows child indices instead of chasing pointers.
+class WordTrie {
+public:
+    static constexpr int kAlphabetSize = 26;
+    static constexpr int kNoNode = -1;
+
+    WordTrie();
+    explicit WordTrie(const std::vector<std::string>& words);
+
+    // Rebuilds the trie for a new word list (letters are upper-cased, words
+    // containing anything other than A-Z are ignored)
+    void build(const std::vector<std::string>& words);
+    void build(const std::string* words, size_t count);
+
+    int root() const { return 0; }
+
+    // Child of a node for a grid letter, or kNoNode when no word continues that way
+    int child(int node, char letter) const {
+        unsigned index = static_cast<unsigned char>(letter) - 'A';
+        return index < kAlphabetSize ? nodes[node].next[index] : kNoNode;
+    }
+
+    // Index of the word ending at this node, or -1
+    int wordAt(int node) const { return nodes[node].word; }
+
+    // Number of words passed to build(), including duplicates and rejected words
+    int wordCount() const { return static_cast<int>(canonical.size()); }
+
+    // Number of distinct words stored in the trie
+    int uniqueWordCount() const { return uniqueWords; }
+
+    // First index with the same spelling as word i, or -1 if word i was rejected
+    int canonicalIndex(int i) const { return canonical[i]; }
+
+    size_t maxWordLength() const { return maxLength; }
+
+private:
+    struct Node {
+        std::array<int, kAlphabetSize> next;
+        int word;
+    };
+
+    int addNode();
+
+    std::vector<Node> nodes;
+    std::vector<int> canonical;
+    int uniqueWords = 0;
+    size_t maxLength = 0;
+};
+
+#endif
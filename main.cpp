@@ -18,6 +18,13 @@
 #include <fstream>
 #include <random>
 #include "WordSearchSolver.h"  
+#include "AllocationCounter.h"
+#include "GridWidget.h"
+#include "Dictionary.h"
+#include "FillEngine.h"
+#include "PuzzlePool.h"
+#include "StopToken.h"
+#include "ValidationCache.h"
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
@@ -30,12 +37,7 @@ static std::vector<bool> foundFlags;	// Flag for each target word (found or not)
 static std::vector<ImVec4> foundWordColors;     // Color assigned for each found word
 static std::string currentSelection;	        // Current selection string (from grid)
 static std::vector<std::pair<int, int>> selectedCells; // Currently selected (but not finalized) cell coordinates
-static std::vector<std::pair<int, int>> usedCells;     // Cells that are finalized (used in a found word)
-static std::vector<ImVec4> usedCellColors;      // Colors assigned to each used cell
-
-// Variables for asynchronous puzzle loading.
-static bool loading = false;
-static std::future<std::vector<std::string>> loadingFuture;
+static std::vector<CellState> cellStates;             // Render state of each cell, row-major
 
 // Fixed Palette of 15 Colors for Found Words
 static const std::vector<ImVec4> fixedPalette = {
@@ -57,12 +59,43 @@ static const std::vector<ImVec4> fixedPalette = {
 };
 
 // Helper Functions
-bool isCellUsed(const std::vector<std::pair<int, int>>& cells, int i, int j) {
-    for (const auto& p : cells) {
-        if (p.first == i && p.second == j)
-            return true;
+CellState& cellState(int i, int j) {
+    return cellStates[static_cast<size_t>(i) * selectedGridSize + j];
+}
+
+// Forgets every selected and found cell, e.g. for a new puzzle of this size
+void resetCells(int size) {
+    selectedCells.clear();
+    cellStates.assign(static_cast<size_t>(size) * size, CellState());
+}
+
+void selectCell(int i, int j, char letter) {
+    selectedCells.push_back({ i, j });
+    cellState(i, j).flags |= CellSelected;
+    currentSelection.push_back(letter);
+}
+
+// Whether a cell outside the selection may extend it: any cell starts a
+// selection, the second must neighbor the first, and later ones must continue
+// in the direction those two set
+bool canSelectCell(int i, int j) {
+    if (selectedCells.empty()) {
+        return true;
+    }
+    auto last = selectedCells.back();
+    if (selectedCells.size() == 1) {
+        return std::abs(i - last.first) <= 1 && std::abs(j - last.second) <= 1;
     }
-    return false;
+    std::pair<int, int> lockedDirection = { selectedCells[1].first - selectedCells[0].first,
+                                            selectedCells[1].second - selectedCells[0].second };
+    return i == last.first + lockedDirection.first && j == last.second + lockedDirection.second;
+}
+
+void clearSelectedCells() {
+    for (const auto& [i, j] : selectedCells) {
+        cellState(i, j).flags &= ~CellSelected;
+    }
+    selectedCells.clear();
 }
 
 // Main Function & ImGui Loop
@@ -73,12 +106,73 @@ int main() {
         std::cerr << "Failed to initialize ImGui-SFML." << std::endl;
         return -1;
     }
+    // Words come from the local list when present; otherwise they are fetched
+    // and validated over HTTPS as before
+    if (!Dictionary::shared().load(Dictionary::kDefaultPath)) {
+        std::cerr << "No local dictionary at " << Dictionary::kDefaultPath
+            << ", falling back to online word APIs." << std::endl;
+        // Words checked in earlier sessions skip the Dictionary API
+        ValidationCache::shared().load(ValidationCache::kDefaultPath);
+    }
+    // Optional; target words are kept from repeating either way
+    FillEngine::shared().loadBlocklist(FillEngine::kDefaultBlocklistPath);
     WordSearchSolver solver;
+    // Puzzles for every mode are generated ahead of time in the background
+    PuzzlePool puzzlePool({ 5, 10, 15 });
+    GridWidget gridWidget;
     sf::Clock deltaClock;
     // Flag to ensure we open the "Puzzle Completed" popup only once.
     static bool puzzleCompletedPopupShown = false;
+    // Heap allocations made by the previous frame on this (the UI) thread;
+    // zero once the UI is idle. Shown only when allocations are counted.
+    size_t frameAllocations = 0;
+
+    // Asynchronous puzzle loading. Each load fills its own solver, which
+    // replaces the game's solver when it completes. These are locals so that
+    // every load is finished before the shared dictionary, caches and pools
+    // are destroyed at exit.
+    bool loading = false;
+    std::future<WordSearchSolver> loadingFuture;
+    StopSource loadingStop;
+    // Cancelled loads still winding down; kept so that dropping their futures
+    // (which waits for the task) never happens on the UI thread mid-load
+    std::vector<std::future<WordSearchSolver>> retiredLoads;
+
+    // Abandons the load in progress, if any, without waiting for it
+    auto cancelLoading = [&]() {
+        if (loadingFuture.valid()) {
+            loadingStop.requestStop();
+            retiredLoads.push_back(std::move(loadingFuture));
+        }
+        loading = false;
+    };
+
+    // Starts a game of the given size with a pooled puzzle, or generates one
+    // behind the loading screen if none is ready yet
+    auto startPuzzle = [&](int size) {
+        selectedGridSize = size;
+        modeSelected = true;
+        currentSelection.clear();
+        resetCells(size);
+        cancelLoading();
+        if (puzzlePool.tryTake(size, solver)) {
+            targetWords = solver.solve();
+            foundFlags = std::vector<bool>(targetWords.size(), false);
+            foundWordColors = std::vector<ImVec4>(targetWords.size(), ImVec4(1, 1, 1, 1));
+            loading = false;
+            return;
+        }
+        loading = true;
+        loadingStop = StopSource();
+        loadingFuture = std::async(std::launch::async, [size, stop = loadingStop.token()]() {
+            WordSearchSolver loaded;
+            loaded.loadGrid(size, stop);
+            return loaded;
+            });
+    };
 
     while (window.isOpen()) {
+        size_t frameStartAllocations = heapAllocationCount();
         // Process SFML events.
         sf::Event event;
         while (window.pollEvent(event)) {
@@ -91,12 +185,16 @@ int main() {
         // Check if asynchronous grid loading is complete.
         if (loading) {
             if (loadingFuture.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
-                targetWords = loadingFuture.get();
+                solver = loadingFuture.get();
+                targetWords = solver.solve();
                 foundFlags = std::vector<bool>(targetWords.size(), false);
                 foundWordColors = std::vector<ImVec4>(targetWords.size(), ImVec4(1, 1, 1, 1));
                 loading = false;
             }
         }
+        retiredLoads.erase(std::remove_if(retiredLoads.begin(), retiredLoads.end(), [](const auto& load) {
+            return load.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready;
+            }), retiredLoads.end());
 
         // Create a full-screen ImGui window.
         float windowWidth = static_cast<float>(window.getSize().x);
@@ -116,13 +214,18 @@ int main() {
                 foundFlags.clear();
                 foundWordColors.clear();
                 currentSelection.clear();
-                selectedCells.clear();
-                usedCells.clear();
-                usedCellColors.clear();
+                resetCells(0);
                 solver = WordSearchSolver(); // Reinitialize the solver.
-                loading = false;
+                cancelLoading();
                 puzzleCompletedPopupShown = false;
             }
+            ImGui::SameLine();
+#ifdef COUNT_HEAP_ALLOCATIONS
+            ImGui::Text("Seed: %llu | Heap allocations last frame: %zu",
+                static_cast<unsigned long long>(solver.getSeed()), frameAllocations);
+#else
+            ImGui::Text("Seed: %llu", static_cast<unsigned long long>(solver.getSeed()));
+#endif
             ImGui::Separator();
         }
 
@@ -132,47 +235,28 @@ int main() {
             ImGui::Text("Select a Difficulty Mode:");
             ImGui::Spacing();
             if (ImGui::Button("Easy (5x5)")) {
-                selectedGridSize = 5;
-                modeSelected = true;
-                currentSelection.clear();
-                selectedCells.clear();
-                usedCells.clear();
-                usedCellColors.clear();
-                loading = true;
-                loadingFuture = std::async(std::launch::async, [&solver]() {
-                    solver.loadGrid(selectedGridSize);
-                    return solver.solve();
-                    });
+                startPuzzle(5);
             }
             ImGui::Spacing();
             if (ImGui::Button("Medium (10x10)")) {
-                selectedGridSize = 10;
-                modeSelected = true;
-                currentSelection.clear();
-                selectedCells.clear();
-                usedCells.clear();
-                usedCellColors.clear();
-                loading = true;
-                loadingFuture = std::async(std::launch::async, [&solver]() {
-                    solver.loadGrid(selectedGridSize);
-                    return solver.solve();
-                    });
+                startPuzzle(10);
             }
             ImGui::Spacing();
             if (ImGui::Button("Expert (15x15)")) {
-                selectedGridSize = 15;
-                modeSelected = true;
-                currentSelection.clear();
-                selectedCells.clear();
-                usedCells.clear();
-                usedCellColors.clear();
-                loading = true;
-                loadingFuture = std::async(std::launch::async, [&solver]() {
-                    solver.loadGrid(selectedGridSize);
-                    return solver.solve();
-                    });
+                startPuzzle(15);
             }
             ImGui::Separator();
+            PuzzlePool::Stats poolStats = puzzlePool.stats();
+            ImGui::SetWindowFontScale(1.0f);
+            ImGui::Text("Ready puzzles: %zu easy, %zu medium, %zu expert | pool hits %zu, misses %zu | refill avg %.2fs, max %.2fs",
+                puzzlePool.ready(5), puzzlePool.ready(10), puzzlePool.ready(15), poolStats.hits, poolStats.misses,
+                poolStats.meanRefillSeconds, poolStats.maxRefillSeconds);
+            if (poolStats.pausedSizes > 0) {
+                ImGui::Text("Word API unreachable: refills paused for %zu sizes (%zu failed so far)",
+                    poolStats.pausedSizes, poolStats.failedRefills);
+            }
+            ImGui::SetWindowFontScale(2.0f);
+            ImGui::Separator();
             if (!targetWords.empty()) {
                 ImGui::Text("Found Words from Last Session:");
                 for (const auto& word : targetWords) {
@@ -196,74 +280,13 @@ int main() {
                 ImGui::Text("Puzzle Grid:");
                 ImGui::Spacing();
                 const auto& grid = solver.getGrid();
-                float cellSize = 40.0f;
-                for (int i = 0; i < selectedGridSize; ++i) {
-                    for (int j = 0; j < selectedGridSize; ++j) {
-                        std::string cellLabel = std::string(1, grid[i][j]) + "##" +
-                            std::to_string(i) + "_" + std::to_string(j);
-                        if (isCellUsed(usedCells, i, j)) {
-                            int idx = -1;
-                            for (int k = 0; k < usedCells.size(); k++) {
-                                if (usedCells[k].first == i && usedCells[k].second == j) {
-                                    idx = k;
-                                    break;
-                                }
-                            }
-                            if (idx >= 0 && idx < usedCellColors.size())
-                                ImGui::PushStyleColor(ImGuiCol_Button, usedCellColors[idx]);
-                            else
-                                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.0f, 0.0f, 1.0f, 1.0f));
-                            if (ImGui::Button(cellLabel.c_str(), ImVec2(cellSize, cellSize))) {
-                                // Always allow pressing to add the character.
-                                selectedCells.push_back({ i, j });
-                                currentSelection.push_back(grid[i][j]);
-                            }
-                            ImGui::PopStyleColor();
-                        }
-                        else {
-                            bool alreadySelected = isCellUsed(selectedCells, i, j);
-                            bool canSelect = false;
-                            if (!alreadySelected) {
-                                if (selectedCells.empty()) {
-                                    canSelect = true;
-                                }
-                                else if (selectedCells.size() == 1) {
-                                    auto last = selectedCells.back();
-                                    if (std::abs(i - last.first) <= 1 && std::abs(j - last.second) <= 1)
-                                        canSelect = true;
-                                }
-                                else {
-                                    std::pair<int, int> lockedDirection = { selectedCells[1].first - selectedCells[0].first,
-                                                                            selectedCells[1].second - selectedCells[0].second };
-                                    auto last = selectedCells.back();
-                                    if (i == last.first + lockedDirection.first &&
-                                        j == last.second + lockedDirection.second)
-                                        canSelect = true;
-                                }
-                            }
-                            if (alreadySelected) {
-                                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.8f, 0.2f, 1.0f));
-                                if (ImGui::Button(cellLabel.c_str(), ImVec2(cellSize, cellSize))) {
-                                    selectedCells.push_back({ i, j });
-                                    currentSelection.push_back(grid[i][j]);
-                                }
-                                ImGui::PopStyleColor();
-                            }
-                            else if (canSelect) {
-                                if (ImGui::Button(cellLabel.c_str(), ImVec2(cellSize, cellSize))) {
-                                    selectedCells.push_back({ i, j });
-                                    currentSelection.push_back(grid[i][j]);
-                                }
-                            }
-                            else {
-                                ImGui::BeginDisabled();
-                                ImGui::Button(cellLabel.c_str(), ImVec2(cellSize, cellSize));
-                                ImGui::EndDisabled();
-                            }
-                        }
-                        ImGui::SameLine();
-                    }
-                    ImGui::NewLine();
+                int clickedRow = 0;
+                int clickedCol = 0;
+                if (gridWidget.draw(grid, cellStates.data(), fixedPalette.data(), canSelectCell, clickedRow, clickedCol)) {
+                    selectCell(clickedRow, clickedCol, grid[clickedRow][clickedCol]);
+                }
+                if (gridWidget.clipped()) {
+                    ImGui::TextDisabled("Mouse wheel zooms, right-drag pans");
                 }
                 ImGui::NextColumn();
 
@@ -279,7 +302,7 @@ int main() {
                 ImGui::Spacing();
                 if (ImGui::Button("Clear", ImVec2(100, 30))) {
                     currentSelection.clear();
-                    selectedCells.clear();
+                    clearSelectedCells();
                 }
                 ImGui::SameLine();
                 if (ImGui::Button("Check Word                                                 ", ImVec2(250, 30))) {
@@ -301,10 +324,12 @@ int main() {
                     if (correct && foundIndex >= 0) {
                         foundFlags[foundIndex] = true;
                         foundWordColors[foundIndex] = fixedPalette[foundIndex % fixedPalette.size()];
-                        for (const auto& cell : selectedCells) {
-                            if (!isCellUsed(usedCells, cell.first, cell.second)) {
-                                usedCells.push_back(cell);
-                                usedCellColors.push_back(foundWordColors[foundIndex]);
+                        // Cells keep the color of the first word found through them
+                        for (const auto& [i, j] : selectedCells) {
+                            CellState& cell = cellState(i, j);
+                            if (!(cell.flags & CellUsed)) {
+                                cell.flags |= CellUsed;
+                                cell.palette = static_cast<uint8_t>(foundIndex % fixedPalette.size());
                             }
                         }
                         ImGui::OpenPopup("Correct");
@@ -318,7 +343,7 @@ int main() {
                     if (ImGui::Button("OK")) {
                         ImGui::CloseCurrentPopup();
                         currentSelection.clear();
-                        selectedCells.clear();
+                        clearSelectedCells();
                     }
                     ImGui::EndPopup();
                 }
@@ -327,7 +352,7 @@ int main() {
                     if (ImGui::Button("OK")) {
                         ImGui::CloseCurrentPopup();
                         currentSelection.clear();
-                        selectedCells.clear();
+                        clearSelectedCells();
                     }
                     ImGui::EndPopup();
                 }
@@ -336,7 +361,7 @@ int main() {
                     if (ImGui::Button("OK")) {
                         ImGui::CloseCurrentPopup();
                         currentSelection.clear();
-                        selectedCells.clear();
+                        clearSelectedCells();
                     }
                     ImGui::EndPopup();
                 }
@@ -362,7 +387,7 @@ int main() {
                     if (ImGui::Button(targetWords[k].c_str(), ImVec2(buttonWidth, buttonHeight))) {
                         // When pressed, update currentSelection with the target word.
                         currentSelection = targetWords[k];
-                        selectedCells.clear();
+                        clearSelectedCells();
                     }
                     ImGui::PopStyleVar();
                     ImGui::PopStyleColor();
@@ -393,9 +418,7 @@ int main() {
                     foundFlags.clear();
                     foundWordColors.clear();
                     currentSelection.clear();
-                    selectedCells.clear();
-                    usedCells.clear();
-                    usedCellColors.clear();
+                    resetCells(0);
                     solver = WordSearchSolver(); // Reinitialize the solver.
                     puzzleCompletedPopupShown = false;
                     ImGui::CloseCurrentPopup();
@@ -408,7 +431,16 @@ int main() {
         window.clear(sf::Color::White);
         ImGui::SFML::Render(window);
         window.display();
+        frameAllocations = heapAllocationCount() - frameStartAllocations;
+    }
+
+    // Stop the current load and wait for it and any cancelled ones, which all
+    // return promptly once stopped
+    cancelLoading();
+    for (auto& load : retiredLoads) {
+        load.wait();
     }
+    retiredLoads.clear();
 
     ImGui::SFML::Shutdown();
     return 0;
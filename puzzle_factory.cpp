@@ -0,0 +1,171 @@
+// Headless puzzle generator for print runs. Generates COUNT puzzles of one
+// size on every core from the local word list and streams them, in order, to
+// a plain-text archive:
+//
+//   puzzle_factory [--dense] [--lengths MIN-MAX] COUNT SIZE [WORDS] [OUTPUT] [SEED]
+//
+// WORDS defaults to one per row, OUTPUT to output/puzzles.txt and SEED to a
+// random one. --dense packs the words so they share letters. --lengths sets
+// the word lengths, which otherwise run from a quarter of SIZE to SIZE, capped
+// at the longest word in the list. Puzzle i is generated from seed SEED + i,
+// so any puzzle in the archive can be regenerated on its own with
+// loadGrid/generateGrid (and setDenseLayout, setWordLengths).
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Dictionary.h"
+#include "FillEngine.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+#include "WordSearchSolver.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Puzzles generated per pool task, and tasks per round between writes
+const size_t kChunkSize = 64;
+const size_t kChunksPerThread = 4;
+
+struct ChunkResult {
+    std::string text;       // Archive entries for the chunk, in puzzle order
+    size_t wordsRequested = 0;
+    size_t wordsPicked = 0;  // Requested words the dictionary had candidates for
+    size_t wordsPlaced = 0;
+    size_t incomplete = 0;  // Puzzles missing at least one requested word
+};
+
+void writePuzzle(std::string& out, size_t index, const WordSearchSolver& solver) {
+    const Grid& grid = solver.getGrid();
+    out += "#" + std::to_string(index) + " seed " + std::to_string(solver.getSeed()) +
+        " size " + std::to_string(grid.width()) + "\n";
+    for (int r = 0; r < grid.height(); ++r) {
+        out.append(grid[r], grid.width());
+        out += '\n';
+    }
+    const std::vector<std::string>& words = solver.getTargetWords();
+    for (size_t i = 0; i < words.size(); ++i) {
+        out += i == 0 ? "" : " ";
+        out += words[i];
+    }
+    out += "\n\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    // Options come before the positional arguments
+    bool dense = false;
+    int minLength = 0;
+    int maxLength = 0;
+    int arg = 1;
+    bool badOption = false;
+    for (; arg < argc && std::string(argv[arg]).rfind("--", 0) == 0; ++arg) {
+        std::string option = argv[arg];
+        if (option == "--dense") {
+            dense = true;
+        }
+        else if (option == "--lengths" && arg + 1 < argc &&
+            std::sscanf(argv[arg + 1], "%d-%d", &minLength, &maxLength) == 2) {
+            arg++;
+        }
+        else {
+            badOption = true;
+        }
+    }
+    std::vector<std::string> args(argv + arg, argv + argc);
+    if (badOption || args.size() < 2) {
+        std::cerr << "Usage: " << argv[0] << " [--dense] [--lengths MIN-MAX] COUNT SIZE [WORDS] [OUTPUT] [SEED]" << std::endl;
+        return 1;
+    }
+    size_t count = std::strtoull(args[0].c_str(), nullptr, 10);
+    int size = std::atoi(args[1].c_str());
+    int numWords = args.size() > 2 ? std::atoi(args[2].c_str()) : size;
+    fs::path outputPath = args.size() > 3 ? fs::path(args[3]) : fs::path("output") / "puzzles.txt";
+    uint64_t seed = args.size() > 4 ? std::strtoull(args[4].c_str(), nullptr, 10) : Rng::randomSeed();
+    if (count == 0 || size < 3 || numWords < 1) {
+        std::cerr << "COUNT and WORDS must be positive and SIZE at least 3." << std::endl;
+        return 1;
+    }
+    if (minLength > maxLength || (maxLength > 0 && minLength < 1)) {
+        std::cerr << "--lengths needs 1 <= MIN <= MAX." << std::endl;
+        return 1;
+    }
+
+    // The online APIs would take seconds per puzzle; a print run needs the local list
+    if (!Dictionary::shared().load(Dictionary::kDefaultPath)) {
+        std::cerr << "No local dictionary at " << Dictionary::kDefaultPath << "." << std::endl;
+        return 1;
+    }
+    FillEngine::shared().loadBlocklist(FillEngine::kDefaultBlocklistPath);
+
+    if (outputPath.has_parent_path()) {
+        fs::create_directories(outputPath.parent_path());
+    }
+    std::ofstream archive(outputPath, std::ios::binary);
+    if (!archive) {
+        std::cerr << "Error opening file: " << outputPath << std::endl;
+        return 1;
+    }
+
+    ThreadPool& pool = ThreadPool::shared();
+    size_t chunks = (count + kChunkSize - 1) / kChunkSize;
+    size_t chunksPerRound = std::max<size_t>(1, pool.size() * kChunksPerThread);
+    std::vector<ChunkResult> round;
+    ChunkResult totals;
+    auto start = std::chrono::steady_clock::now();
+
+    // Each round generates in parallel, then appends its chunks in order, so
+    // memory stays bounded by one round however many puzzles are requested
+    for (size_t first = 0; first < chunks; first += chunksPerRound) {
+        size_t roundChunks = std::min(chunksPerRound, chunks - first);
+        round.assign(roundChunks, ChunkResult());
+        pool.parallelFor(roundChunks, [&](size_t k) {
+            ChunkResult& result = round[k];
+            WordSearchSolver solver;
+            solver.setDenseLayout(dense);
+            solver.setWordLengths(minLength, maxLength);
+            size_t begin = (first + k) * kChunkSize;
+            size_t end = std::min(count, begin + kChunkSize);
+            for (size_t i = begin; i < end; ++i) {
+                solver.generateGrid(size, numWords, seed + i);
+                size_t placed = solver.getTargetWords().size();
+                result.wordsRequested += numWords;
+                result.wordsPicked += solver.getPickedWordCount();
+                result.wordsPlaced += placed;
+                result.incomplete += placed < static_cast<size_t>(numWords) ? 1 : 0;
+                writePuzzle(result.text, i, solver);
+            }
+        });
+        for (const ChunkResult& result : round) {
+            archive << result.text;
+            totals.wordsRequested += result.wordsRequested;
+            totals.wordsPicked += result.wordsPicked;
+            totals.wordsPlaced += result.wordsPlaced;
+            totals.incomplete += result.incomplete;
+        }
+    }
+    archive.close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // Only words the placer was given count against it; words the dictionary
+    // had no candidates for are reported separately
+    double failureRate = totals.wordsPicked > 0
+        ? 1.0 - static_cast<double>(totals.wordsPlaced) / totals.wordsPicked : 0.0;
+    std::cout << "Generated " << count << (dense ? " dense" : "") << " puzzles of " << size << "x" << size
+        << " on " << pool.size()
+        << " threads in " << seconds << " s (" << (seconds > 0 ? count / seconds : 0.0) << " puzzles/s)\n"
+        << "Words picked: " << totals.wordsPicked << " of " << totals.wordsRequested << " requested\n"
+        << "Words placed: " << totals.wordsPlaced << " of " << totals.wordsPicked
+        << " picked (placement failure rate " << failureRate * 100.0 << "%, "
+        << totals.incomplete << " puzzles incomplete)\n"
+        << "Base seed " << seed << ", archive " << outputPath << std::endl;
+    return 0;
+}